@@ -0,0 +1,440 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkBenchmarkCommandlet.h"
+#include "NeuralNetworkModel.h"
+#include "NeuralNetworkStats.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+namespace NeuralNetworkBenchmark
+{
+    struct FFrame
+    {
+        TArray<uint8> Pixels;
+        int32 Width = 0;
+        int32 Height = 0;
+        ENeuralNetworkPixelFormat Format = ENeuralNetworkPixelFormat::RGBA8;
+    };
+
+    struct FStageSummary
+    {
+        FString Name;
+        double Mean = 0.0;
+        double P50 = 0.0;
+        double P95 = 0.0;
+        double P99 = 0.0;
+    };
+
+    // Nearest rank percentile of already sorted samples
+    static double Percentile(const TArray<double>& Sorted, double Percent)
+    {
+        if (Sorted.Num() == 0)
+        {
+            return 0.0;
+        }
+        const int32 Rank = FMath::CeilToInt32(Percent / 100.0 * Sorted.Num()) - 1;
+        return Sorted[FMath::Clamp(Rank, 0, Sorted.Num() - 1)];
+    }
+
+    static FStageSummary Summarize(const FString& Name, TArray<double> Samples)
+    {
+        FStageSummary Summary;
+        Summary.Name = Name;
+        if (Samples.Num() == 0)
+        {
+            return Summary;
+        }
+
+        Samples.Sort();
+        double Sum = 0.0;
+        for (double Sample : Samples)
+        {
+            Sum += Sample;
+        }
+        Summary.Mean = Sum / Samples.Num();
+        Summary.P50 = Percentile(Samples, 50.0);
+        Summary.P95 = Percentile(Samples, 95.0);
+        Summary.P99 = Percentile(Samples, 99.0);
+        return Summary;
+    }
+
+    static bool LoadFrames(UNeuralNetworkModel* Model, const FString& ImageDir, const FString& RecordingPath, int32 Width, int32 Height, TArray<FFrame>& OutFrames)
+    {
+        if (!RecordingPath.IsEmpty())
+        {
+            FNeuralNetworkRecordingReader Recording;
+            if (!Recording.Open(RecordingPath) || Recording.GetFormat() != ENeuralNetworkRecordingFormat::Pixels)
+            {
+                UE_LOG(LogNeuralNetwork, Error, TEXT("Benchmark: %s is not a pixel recording"), *RecordingPath);
+                return false;
+            }
+
+            // Copied out so every iteration reads the same memory as the PNG path
+            TArray<uint8> Scratch;
+            for (int32 i = 0; i < Recording.Num(); i++)
+            {
+                FNeuralNetworkImageView Image;
+                if (Recording.GetImage(i, Scratch, Image))
+                {
+                    FFrame& Frame = OutFrames.AddDefaulted_GetRef();
+                    Frame.Pixels.Append(Image.Pixels, Image.RowStride * Image.Height);
+                    Frame.Width = Image.Width;
+                    Frame.Height = Image.Height;
+                    Frame.Format = Image.Format;
+                }
+            }
+
+            UE_LOG(LogNeuralNetwork, Display, TEXT("Benchmark: Loaded %d frames from %s"), OutFrames.Num(), *RecordingPath);
+            return OutFrames.Num() > 0;
+        }
+
+        if (!ImageDir.IsEmpty())
+        {
+            TArray<FString> Files;
+            IFileManager::Get().FindFiles(Files, *(ImageDir / TEXT("*.png")), true, false);
+            Files.Sort();
+
+            for (const FString& File : Files)
+            {
+                FFrame& Frame = OutFrames.AddDefaulted_GetRef();
+                Frame.Pixels = Model->LoadPNGToPixelArray(ImageDir / File, Frame.Width, Frame.Height);
+                if (Frame.Pixels.Num() == 0)
+                {
+                    OutFrames.Pop();
+                }
+            }
+
+            UE_LOG(LogNeuralNetwork, Display, TEXT("Benchmark: Loaded %d frames from %s"), OutFrames.Num(), *ImageDir);
+            return OutFrames.Num() > 0;
+        }
+
+        // Synthetic noise frames, deterministic so runs are comparable
+        FRandomStream Random(1234);
+        for (int32 f = 0; f < 4; f++)
+        {
+            FFrame& Frame = OutFrames.AddDefaulted_GetRef();
+            Frame.Width = Width;
+            Frame.Height = Height;
+            Frame.Pixels.SetNumUninitialized(Width * Height * 4);
+            for (uint8& Byte : Frame.Pixels)
+            {
+                Byte = static_cast<uint8>(Random.RandHelper(256));
+            }
+        }
+
+        UE_LOG(LogNeuralNetwork, Display, TEXT("Benchmark: Using %d synthetic %dx%d frames"), OutFrames.Num(), Width, Height);
+        return true;
+    }
+
+    // Fraction of Reference boxes that have a box of the same class in Candidates overlapping them by IoU >= 0.5
+    static double MatchedFraction(const TArray<FNeuralNetworkDetection>& Reference, const TArray<FNeuralNetworkDetection>& Candidates)
+    {
+        if (Reference.Num() == 0)
+        {
+            return 1.0;
+        }
+
+        int32 Matched = 0;
+        for (const FNeuralNetworkDetection& A : Reference)
+        {
+            for (const FNeuralNetworkDetection& B : Candidates)
+            {
+                if (A.ClassId == B.ClassId && NeuralNetworkDetection::IntersectionOverUnion(A, B) >= 0.5f)
+                {
+                    Matched++;
+                    break;
+                }
+            }
+        }
+        return static_cast<double>(Matched) / Reference.Num();
+    }
+
+    static FString FormatJson(const FString& Runtime, const FString& ModelPath, const TArray<int32>& InputShape, int32 NumFrames, int32 Warmup,
+        int32 Iterations, double FramesPerSecond, double PeakMemoryMB, const TArray<FStageSummary>& Stages, const TArray<TPair<FString, double>>& Metrics)
+    {
+        FString Json = TEXT("{\n");
+        Json += FString::Printf(TEXT("  \"runtime\": \"%s\",\n"), *Runtime);
+        Json += FString::Printf(TEXT("  \"model\": \"%s\",\n"), *ModelPath);
+        Json += FString::Printf(TEXT("  \"input_shape\": [%s],\n"), *FString::JoinBy(InputShape, TEXT(", "), [](int32 Val) { return FString::FromInt(Val); }));
+        Json += FString::Printf(TEXT("  \"frames\": %d,\n  \"warmup\": %d,\n  \"iterations\": %d,\n"), NumFrames, Warmup, Iterations);
+        Json += FString::Printf(TEXT("  \"fps\": %.3f,\n  \"peak_memory_mb\": %.1f,\n"), FramesPerSecond, PeakMemoryMB);
+        if (Metrics.Num() > 0)
+        {
+            Json += TEXT("  \"metrics\": {\n");
+            for (int32 i = 0; i < Metrics.Num(); i++)
+            {
+                Json += FString::Printf(TEXT("    \"%s\": %.4f%s\n"), *Metrics[i].Key, Metrics[i].Value, i + 1 < Metrics.Num() ? TEXT(",") : TEXT(""));
+            }
+            Json += TEXT("  },\n");
+        }
+        Json += TEXT("  \"stages_ms\": {\n");
+        for (int32 i = 0; i < Stages.Num(); i++)
+        {
+            const FStageSummary& Stage = Stages[i];
+            Json += FString::Printf(TEXT("    \"%s\": { \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f }%s\n"),
+                *Stage.Name, Stage.Mean, Stage.P50, Stage.P95, Stage.P99, i + 1 < Stages.Num() ? TEXT(",") : TEXT(""));
+        }
+        Json += TEXT("  }\n}\n");
+        return Json;
+    }
+
+    // One row per stage, the run wide values and metrics repeated as extra columns so the file stays a single table
+    static FString FormatCsv(const FString& Runtime, double FramesPerSecond, double PeakMemoryMB, const TArray<FStageSummary>& Stages, const TArray<TPair<FString, double>>& Metrics)
+    {
+        FString Csv = TEXT("runtime,stage,mean_ms,p50_ms,p95_ms,p99_ms,fps,peak_memory_mb");
+        for (const TPair<FString, double>& Metric : Metrics)
+        {
+            Csv += TEXT(",") + Metric.Key;
+        }
+        Csv += TEXT("\n");
+
+        for (const FStageSummary& Stage : Stages)
+        {
+            Csv += FString::Printf(TEXT("%s,%s,%.4f,%.4f,%.4f,%.4f,%.3f,%.1f"),
+                *Runtime, *Stage.Name, Stage.Mean, Stage.P50, Stage.P95, Stage.P99, FramesPerSecond, PeakMemoryMB);
+            for (const TPair<FString, double>& Metric : Metrics)
+            {
+                Csv += FString::Printf(TEXT(",%.4f"), Metric.Value);
+            }
+            Csv += TEXT("\n");
+        }
+        return Csv;
+    }
+}
+
+// ######################################################################################################################
+
+UNeuralNetworkBenchmarkCommandlet::UNeuralNetworkBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+}
+
+/*
+- Parameters:
+ 1) Params: The command line, see the header for the accepted switches.
+- What it does: Loads the model through CreateModel, runs warm-up iterations and then timed iterations of
+  preprocess -> RunPrepared -> decode over the frames, and reports latency percentiles per stage, frames per second and
+  peak memory to the log and optionally to a JSON or CSV file.
+- Return Value: int32 process exit code, 0 on success.
+*/
+int32 UNeuralNetworkBenchmarkCommandlet::Main(const FString& Params)
+{
+    using namespace NeuralNetworkBenchmark;
+
+    FString ModelPath = TEXT("/Game/yolov8n");
+    FString RuntimeName = TEXT("NNERuntimeORTCpu");
+    FString ImageDir;
+    FString RecordingPath;
+    FString OutputPath;
+    int32 Warmup = 10;
+    int32 Iterations = 200;
+    int32 Width = 1280;
+    int32 Height = 720;
+
+    FParse::Value(*Params, TEXT("Model="), ModelPath);
+    FParse::Value(*Params, TEXT("Runtime="), RuntimeName);
+    FParse::Value(*Params, TEXT("ImageDir="), ImageDir);
+    FParse::Value(*Params, TEXT("Recording="), RecordingPath);
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+    FParse::Value(*Params, TEXT("Warmup="), Warmup);
+    FParse::Value(*Params, TEXT("Iterations="), Iterations);
+    FParse::Value(*Params, TEXT("Width="), Width);
+    FParse::Value(*Params, TEXT("Height="), Height);
+    const bool bTiled = FParse::Param(*Params, TEXT("Tiled"));
+    FNeuralNetworkTilingSettings TilingSettings;
+    int32 TilePoolSize = 0;
+    FParse::Value(*Params, TEXT("TileSize="), TilingSettings.TileSize);
+    FParse::Value(*Params, TEXT("TileOverlap="), TilingSettings.Overlap);
+    FParse::Value(*Params, TEXT("TilePooled="), TilePoolSize);
+    Iterations = FMath::Max(1, Iterations);
+    Warmup = FMath::Max(0, Warmup);
+
+    UNNEModelData* ModelData = LoadObject<UNNEModelData>(nullptr, *ModelPath);
+    UNeuralNetworkModel* Model = UNeuralNetworkModel::CreateModel(GetTransientPackage(), RuntimeName, ModelData);
+    if (!Model)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Benchmark: Could not create the model %s on %s"), *ModelPath, *RuntimeName);
+        return 1;
+    }
+    Model->AddToRoot();
+
+    // Report the runtime that actually ran, not "Auto"
+    if (NeuralNetworkRuntimeSelection::IsAuto(RuntimeName))
+    {
+        RuntimeName = UNeuralNetworkModel::GetRuntimeSelection().SelectedRuntime;
+    }
+
+    TArray<FFrame> Frames;
+    if (!LoadFrames(Model, ImageDir, RecordingPath, Width, Height, Frames))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Benchmark: No frames to run"));
+        Model->RemoveFromRoot();
+        return 1;
+    }
+
+    TArray<FNeuralNetworkTensor> Inputs;
+    Inputs.SetNum(1);
+    const TArray<int32> InputShape = Model->GetInputShape(0);
+    UNeuralNetworkModel::CreateTensor(InputShape, Inputs[0]);
+
+    TArray<FNeuralNetworkTensor> Outputs;
+    Outputs.SetNum(Model->NumOutputs());
+    for (int32 i = 0; i < Outputs.Num(); i++)
+    {
+        UNeuralNetworkModel::CreateTensor(Model->GetOutputShape(i), Outputs[i]);
+    }
+
+    if (!Model->PrepareSession(Inputs, Outputs))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Benchmark: Could not prepare the session"));
+        Model->RemoveFromRoot();
+        return 1;
+    }
+
+    const FNeuralNetworkDecodeSettings DecodeSettings;
+    FNeuralNetworkLetterbox Letterbox;
+    TArray<FNeuralNetworkDetection> Detections;
+
+    TArray<double> PreprocessMs, RunMs, DecodeMs, TotalMs;
+    PreprocessMs.Reserve(Iterations);
+    RunMs.Reserve(Iterations);
+    DecodeMs.Reserve(Iterations);
+    TotalMs.Reserve(Iterations);
+
+    double TimedSeconds = 0.0;
+    for (int32 Iteration = 0; Iteration < Warmup + Iterations; Iteration++)
+    {
+        const FFrame& Frame = Frames[Iteration % Frames.Num()];
+
+        const double Start = FPlatformTime::Seconds();
+        UNeuralNetworkModel::PreprocessPixels(Frame.Pixels, Frame.Width, Frame.Height, Frame.Format, Inputs[0], Letterbox);
+        const double Preprocessed = FPlatformTime::Seconds();
+        const bool bRan = Model->RunPrepared();
+        const double Ran = FPlatformTime::Seconds();
+        UNeuralNetworkModel::DecodeDetections(Outputs[0], Letterbox, DecodeSettings, Detections);
+        const double Decoded = FPlatformTime::Seconds();
+
+        if (!bRan)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Benchmark: Inference failed at iteration %d"), Iteration);
+            Model->RemoveFromRoot();
+            return 1;
+        }
+
+        if (Iteration >= Warmup)
+        {
+            PreprocessMs.Add((Preprocessed - Start) * 1000.0);
+            RunMs.Add((Ran - Preprocessed) * 1000.0);
+            DecodeMs.Add((Decoded - Ran) * 1000.0);
+            TotalMs.Add((Decoded - Start) * 1000.0);
+            TimedSeconds += Decoded - Start;
+        }
+    }
+
+    TArray<FStageSummary> Stages;
+    Stages.Add(Summarize(TEXT("preprocess"), PreprocessMs));
+    Stages.Add(Summarize(TEXT("run"), RunMs));
+    Stages.Add(Summarize(TEXT("decode"), DecodeMs));
+    Stages.Add(Summarize(TEXT("total"), TotalMs));
+
+    // Tiled vs single input on the same frames. Without ground truth the tiled result is the reference: the single
+    // input recall is the share of tiled detections it also finds, the rest are mostly small objects lost to scaling.
+    TArray<TPair<FString, double>> Metrics;
+    if (bTiled)
+    {
+        if (TilePoolSize > 0)
+        {
+            TilingSettings.Execution = ENeuralNetworkTileExecution::Pooled;
+            if (!Model->CreateInstancePool(TilePoolSize))
+            {
+                Model->RemoveFromRoot();
+                return 1;
+            }
+        }
+
+        TArray<FNeuralNetworkDetection> SingleDetections, TiledDetections;
+        TArray<double> TiledMs;
+        double SingleCount = 0.0, TiledCount = 0.0, SingleRecall = 0.0;
+        TiledMs.Reserve(Iterations);
+
+        for (int32 Iteration = 0; Iteration < Warmup + Iterations; Iteration++)
+        {
+            const FFrame& Frame = Frames[Iteration % Frames.Num()];
+
+            FNeuralNetworkImageView Image;
+            Image.Pixels = Frame.Pixels.GetData();
+            Image.Width = Frame.Width;
+            Image.Height = Frame.Height;
+            Image.RowStride = Frame.Width * 4;
+            Image.Format = Frame.Format;
+
+            const double Start = FPlatformTime::Seconds();
+            const bool bRan = Model->DetectTiledImage(Image, DecodeSettings, TilingSettings, TiledDetections);
+            const double End = FPlatformTime::Seconds();
+
+            if (!bRan || !Model->DetectImage(Image, DecodeSettings, SingleDetections))
+            {
+                UE_LOG(LogNeuralNetwork, Error, TEXT("Benchmark: Tiled inference failed at iteration %d"), Iteration);
+                Model->RemoveFromRoot();
+                return 1;
+            }
+
+            if (Iteration >= Warmup)
+            {
+                TiledMs.Add((End - Start) * 1000.0);
+                SingleCount += SingleDetections.Num();
+                TiledCount += TiledDetections.Num();
+                SingleRecall += MatchedFraction(TiledDetections, SingleDetections);
+            }
+        }
+
+        Stages.Add(Summarize(TEXT("tiled"), TiledMs));
+        Metrics.Add({ TEXT("tile_size"), static_cast<double>(TilingSettings.TileSize) });
+        Metrics.Add({ TEXT("tile_overlap"), static_cast<double>(TilingSettings.Overlap) });
+        Metrics.Add({ TEXT("single_detections_per_frame"), SingleCount / Iterations });
+        Metrics.Add({ TEXT("tiled_detections_per_frame"), TiledCount / Iterations });
+        Metrics.Add({ TEXT("single_recall_vs_tiled"), SingleRecall / Iterations });
+
+        UE_LOG(LogNeuralNetwork, Display, TEXT("Benchmark: Tiled %d px / %.0f%% overlap, %.1f detections per frame vs %.1f single input, single input recall vs tiled %.1f%%"),
+            TilingSettings.TileSize, TilingSettings.Overlap * 100.0f, TiledCount / Iterations, SingleCount / Iterations, SingleRecall / Iterations * 100.0);
+    }
+
+    const double FramesPerSecond = TimedSeconds > 0.0 ? Iterations / TimedSeconds : 0.0;
+    const double PeakMemoryMB = FPlatformMemory::GetStats().PeakUsedPhysical / (1024.0 * 1024.0);
+
+    UE_LOG(LogNeuralNetwork, Display, TEXT("Benchmark: %s, %d iterations after %d warm-up, %.2f frames/s, peak memory %.1f MB"),
+        *RuntimeName, Iterations, Warmup, FramesPerSecond, PeakMemoryMB);
+    for (const FStageSummary& Stage : Stages)
+    {
+        UE_LOG(LogNeuralNetwork, Display, TEXT("Benchmark: %-10s mean %8.3f ms  p50 %8.3f ms  p95 %8.3f ms  p99 %8.3f ms"),
+            *Stage.Name, Stage.Mean, Stage.P50, Stage.P95, Stage.P99);
+    }
+
+    if (!OutputPath.IsEmpty())
+    {
+        const bool bCsv = FPaths::GetExtension(OutputPath).Equals(TEXT("csv"), ESearchCase::IgnoreCase);
+        const FString Report = bCsv
+            ? FormatCsv(RuntimeName, FramesPerSecond, PeakMemoryMB, Stages, Metrics)
+            : FormatJson(RuntimeName, ModelPath, InputShape, Frames.Num(), Warmup, Iterations, FramesPerSecond, PeakMemoryMB, Stages, Metrics);
+
+        if (!FFileHelper::SaveStringToFile(Report, *OutputPath))
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Benchmark: Could not write %s"), *OutputPath);
+            Model->RemoveFromRoot();
+            return 1;
+        }
+        UE_LOG(LogNeuralNetwork, Display, TEXT("Benchmark: Wrote %s"), *OutputPath);
+    }
+
+    Model->RemoveFromRoot();
+    return 0;
+}
@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "NeuralNetworkBenchmarkCommandlet.generated.h"
+
+
+/*
+ Headless benchmark of the preprocess -> RunSync -> decode pipeline, safe to run under -nullrhi on a machine
+ without a GPU:
+
+ UnrealEditor-Cmd <Project>.uproject -run=NeuralNetworkBenchmark -nullrhi -unattended
+     [-Model=/Game/yolov8n] [-Runtime=NNERuntimeORTCpu] [-ImageDir=<folder of PNGs> | -Recording=<file>]
+     [-Warmup=10] [-Iterations=200] [-Width=1280] [-Height=720] [-Output=<file>.json|.csv]
+     [-Tiled [-TileSize=640] [-TileOverlap=0.2] [-TilePooled=4]]
+
+ -Tiled additionally times DetectTiled on the same frames and compares its detections with the single input run,
+ use 2K+ frames from -ImageDir to see the recall / latency tradeoff. -Runtime=Auto benchmarks the CPU runtimes
+ first (or reuses the cached choice) and reports the one selected. -Recording replays the frames of a Pixels
+ recording made with UNeuralNetworkModel::StartRecording instead of decoding PNGs.
+*/
+UCLASS()
+class TUTORIAL_API UNeuralNetworkBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UNeuralNetworkBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
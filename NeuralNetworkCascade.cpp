@@ -0,0 +1,193 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkCascade.h"
+#include "NeuralNetworkStats.h"
+
+#include "Async/ParallelFor.h"
+
+namespace NeuralNetworkCascade
+{
+    static constexpr float InvByte = 1.0f / 255.0f;
+
+    // ImageNet statistics in RGB order, on [0, 1] values
+    static constexpr float ImageNetMean[3] = { 0.485f, 0.456f, 0.406f };
+    static constexpr float ImageNetStd[3] = { 0.229f, 0.224f, 0.225f };
+
+    // Source sample positions of one output column or row, shared by the whole crop
+    struct FTap
+    {
+        int32 First;
+        int32 Second;
+        float Weight; // of Second
+    };
+    using FTaps = TArray<FTap, TInlineAllocator<512>>;
+
+    static void ComputeTaps(double Start, double Extent, int32 NumOut, int32 SourceSize, FTaps& OutTaps)
+    {
+        OutTaps.SetNumUninitialized(NumOut);
+        const double Step = Extent / NumOut;
+        for (int32 i = 0; i < NumOut; i++)
+        {
+            const double Position = FMath::Clamp(Start + (i + 0.5) * Step - 0.5, 0.0, static_cast<double>(SourceSize - 1));
+            const int32 First = FMath::FloorToInt32(Position);
+            OutTaps[i].First = First;
+            OutTaps[i].Second = FMath::Min(First + 1, SourceSize - 1);
+            OutTaps[i].Weight = static_cast<float>(Position - First);
+        }
+    }
+}
+
+// ######################################################################################################################
+
+/*
+- Parameters:
+ 1) Detections: The detector output.
+ 2) Settings: Score threshold and crop cap.
+ 3) OutSelected: Receives the indices into Detections to classify.
+- What it does: Picks the highest scoring detections above MinScore with a box of at least a pixel, capped at MaxCrops.
+- Return Value: None.
+*/
+void NeuralNetworkCascade::SelectCrops(const TArray<FNeuralNetworkDetection>& Detections, const FNeuralNetworkCascadeSettings& Settings, TArray<int32>& OutSelected)
+{
+    OutSelected.Reset();
+    for (int32 i = 0; i < Detections.Num(); i++)
+    {
+        const FNeuralNetworkDetection& Detection = Detections[i];
+        if (Detection.Score >= Settings.MinScore && Detection.Max.X - Detection.Min.X >= 1.0 && Detection.Max.Y - Detection.Min.Y >= 1.0)
+        {
+            OutSelected.Add(i);
+        }
+    }
+
+    OutSelected.Sort([&Detections](int32 A, int32 B)
+    {
+        return Detections[A].Score > Detections[B].Score;
+    });
+
+    if (OutSelected.Num() > FMath::Max(0, Settings.MaxCrops))
+    {
+        OutSelected.SetNum(FMath::Max(0, Settings.MaxCrops), false);
+    }
+}
+
+/*
+- Parameters:
+ 1) Image: The source frame.
+ 2) Min, Max: The region to crop in source pixels, may reach outside the image, the border pixels are repeated.
+ 3) Width, Height: Size of the output tensor.
+ 4) bImageNetNormalization: Normalize with the ImageNet statistics instead of plain [0, 1].
+ 5) OutTensor: Receives 3 x Height x Width floats, planar RGB.
+- What it does: Stretches the region to the output size with bilinear filtering. Crops are usually upscaled, where
+  the nearest neighbour sampling of the detector's letterbox would show blocks.
+- Return Value: None.
+*/
+void NeuralNetworkCascade::CropResize(const FNeuralNetworkImageView& Image, const FVector2D& Min, const FVector2D& Max, int32 Width, int32 Height,
+    bool bImageNetNormalization, float* OutTensor)
+{
+    FTaps Columns;
+    FTaps Rows;
+    ComputeTaps(Min.X, Max.X - Min.X, Width, Image.Width, Columns);
+    ComputeTaps(Min.Y, Max.Y - Min.Y, Height, Image.Height, Rows);
+
+    // Byte of R, G and B within a pixel
+    const bool bBGRA = Image.Format == ENeuralNetworkPixelFormat::BGRA8;
+    const int32 ChannelOffsets[3] = { bBGRA ? 2 : 0, 1, bBGRA ? 0 : 2 };
+
+    float Scale[3];
+    float Bias[3];
+    for (int32 c = 0; c < 3; c++)
+    {
+        Scale[c] = bImageNetNormalization ? InvByte / ImageNetStd[c] : InvByte;
+        Bias[c] = bImageNetNormalization ? -ImageNetMean[c] / ImageNetStd[c] : 0.0f;
+    }
+
+    const int32 PlaneSize = Width * Height;
+    const int32 RowStride = Image.RowStride > 0 ? Image.RowStride : Image.Width * 4;
+    for (int32 y = 0; y < Height; y++)
+    {
+        const uint8* Top = Image.Pixels + static_cast<int64>(Rows[y].First) * RowStride;
+        const uint8* Bottom = Image.Pixels + static_cast<int64>(Rows[y].Second) * RowStride;
+        const float WeightY = Rows[y].Weight;
+
+        for (int32 x = 0; x < Width; x++)
+        {
+            const FTap& Column = Columns[x];
+            const int32 Left = Column.First * 4;
+            const int32 Right = Column.Second * 4;
+
+            for (int32 c = 0; c < 3; c++)
+            {
+                const int32 Channel = ChannelOffsets[c];
+                const float Upper = FMath::Lerp(static_cast<float>(Top[Left + Channel]), static_cast<float>(Top[Right + Channel]), Column.Weight);
+                const float Lower = FMath::Lerp(static_cast<float>(Bottom[Left + Channel]), static_cast<float>(Bottom[Right + Channel]), Column.Weight);
+                OutTensor[c * PlaneSize + y * Width + x] = FMath::Lerp(Upper, Lower, WeightY) * Scale[c] + Bias[c];
+            }
+        }
+    }
+}
+
+/*
+- Parameters:
+ 1) Image: The frame the detections were made on.
+ 2) Detections: The detector output.
+ 3) Selected: Indices of the detections to crop, in batch order.
+ 4) Width, Height: Classifier input size.
+ 5) Settings: Padding and normalization.
+ 6) OutBatch: Receives Selected.Num() x 3 x Height x Width floats.
+- What it does: Crops and resizes all selected boxes in a single ParallelFor, each crop writing its own slice of the
+  batch, so the classifier can run them all in one call.
+- Return Value: None.
+*/
+void NeuralNetworkCascade::PackCrops(const FNeuralNetworkImageView& Image, const TArray<FNeuralNetworkDetection>& Detections, TConstArrayView<int32> Selected,
+    int32 Width, int32 Height, const FNeuralNetworkCascadeSettings& Settings, float* OutBatch)
+{
+    NEURAL_NETWORK_SCOPE(Preprocess);
+
+    const int32 CropVolume = 3 * Width * Height;
+    ParallelFor(Selected.Num(), [&](int32 i)
+    {
+        const FNeuralNetworkDetection& Detection = Detections[Selected[i]];
+        const FVector2D Padding = (Detection.Max - Detection.Min) * Settings.CropPadding;
+        CropResize(Image, Detection.Min - Padding, Detection.Max + Padding, Width, Height, Settings.bImageNetNormalization,
+            OutBatch + static_cast<int64>(i) * CropVolume);
+    }, Selected.Num() < 2);
+}
+
+/*
+- Parameters:
+ 1) Scores: One output row of the classifier.
+ 2) NumClasses: Length of the row.
+ 3) bApplySoftmax: Scores are logits.
+ 4) OutClass, OutScore: Receive the argmax and its score, or probability with bApplySoftmax.
+- What it does: Argmax, plus the softmax of the winner only, which needs the row's sum but not the full distribution.
+- Return Value: None.
+*/
+void NeuralNetworkCascade::ReadClass(const float* Scores, int32 NumClasses, bool bApplySoftmax, int32& OutClass, float& OutScore)
+{
+    OutClass = INDEX_NONE;
+    OutScore = 0.0f;
+    if (!Scores || NumClasses < 1)
+    {
+        return;
+    }
+
+    int32 Best = 0;
+    for (int32 c = 1; c < NumClasses; c++)
+    {
+        Best = Scores[c] > Scores[Best] ? c : Best;
+    }
+
+    OutClass = Best;
+    OutScore = Scores[Best];
+    if (bApplySoftmax)
+    {
+        // Shifted by the maximum so the exponentials cannot overflow, the winner contributes exactly 1
+        double Sum = 0.0;
+        for (int32 c = 0; c < NumClasses; c++)
+        {
+            Sum += FMath::Exp(Scores[c] - Scores[Best]);
+        }
+        OutScore = static_cast<float>(1.0 / Sum);
+    }
+}
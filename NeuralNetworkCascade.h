@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkDetection.h"
+#include "NeuralNetworkPreprocess.h"
+
+#include "NeuralNetworkCascade.generated.h"
+
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkCascadeSettings
+{
+    GENERATED_BODY()
+
+public:
+
+    // At most this many detections per frame are classified, highest score first, the rest keep SubClassId INDEX_NONE
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 MaxCrops = 16;
+
+    // Detections scoring below this are not classified
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float MinScore = 0.25f;
+
+    // Every box is grown by this fraction of its size on each side before cropping, for some context
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float CropPadding = 0.1f;
+
+    // Crop size used when the classifier's input height and width are dynamic
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 InputSize = 224;
+
+    // Normalize the crops with the ImageNet mean and standard deviation instead of plain [0, 1]
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    bool bImageNetNormalization = true;
+
+    // The classifier outputs logits, SubClassScore is then the softmax probability
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    bool bApplySoftmax = true;
+};
+
+namespace NeuralNetworkCascade
+{
+    // Indices of the detections to classify, highest score first, at most Settings.MaxCrops
+    TUTORIAL_API void SelectCrops(const TArray<FNeuralNetworkDetection>& Detections, const FNeuralNetworkCascadeSettings& Settings, TArray<int32>& OutSelected);
+
+    // Bilinearly resizes the Min..Max region of the image into a 3 x Height x Width planar RGB tensor
+    TUTORIAL_API void CropResize(const FNeuralNetworkImageView& Image, const FVector2D& Min, const FVector2D& Max, int32 Width, int32 Height,
+        bool bImageNetNormalization, float* OutTensor);
+
+    // Crops every selected detection (padded by Settings.CropPadding) into consecutive tensors of OutBatch,
+    // one task per crop
+    TUTORIAL_API void PackCrops(const FNeuralNetworkImageView& Image, const TArray<FNeuralNetworkDetection>& Detections, TConstArrayView<int32> Selected,
+        int32 Width, int32 Height, const FNeuralNetworkCascadeSettings& Settings, float* OutBatch);
+
+    // Best class of one classifier output row
+    TUTORIAL_API void ReadClass(const float* Scores, int32 NumClasses, bool bApplySoftmax, int32& OutClass, float& OutScore);
+}
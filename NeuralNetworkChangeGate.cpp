@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkChangeGate.h"
+#include "NeuralNetworkStats.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+    #include <arm_neon.h>
+    #define NN_CHANGE_GATE_NEON 1
+#else
+    #define NN_CHANGE_GATE_NEON 0
+#endif
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+    #include <emmintrin.h>
+    #define NN_CHANGE_GATE_SSE 1
+#else
+    #define NN_CHANGE_GATE_SSE 0
+#endif
+
+namespace NeuralNetworkChangeGate
+{
+    // Point samples per cell along each axis, the cell average is taken over SamplesPerCell^2 pixels
+    static constexpr int32 SamplesPerCell = 4;
+
+    // Sum of absolute differences and the number of bytes differing by more than Threshold
+    static void CompareSignatures(const uint8* A, const uint8* B, int32 NumBytes, uint8 Threshold, uint64& OutSum, int32& OutChanged)
+    {
+        uint64 Sum = 0;
+        int32 Changed = 0;
+        int32 i = 0;
+
+#if NN_CHANGE_GATE_SSE
+        {
+            const __m128i Limit = _mm_set1_epi8(static_cast<char>(Threshold));
+            const __m128i Zero = _mm_setzero_si128();
+            __m128i SumVector = _mm_setzero_si128();
+            for (; i + 16 <= NumBytes; i += 16)
+            {
+                const __m128i VA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(A + i));
+                const __m128i VB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(B + i));
+                SumVector = _mm_add_epi64(SumVector, _mm_sad_epu8(VA, VB));
+
+                // |A - B| > Threshold  <=>  saturating (|A - B| - Threshold) != 0
+                const __m128i Difference = _mm_or_si128(_mm_subs_epu8(VA, VB), _mm_subs_epu8(VB, VA));
+                const __m128i Over = _mm_cmpeq_epi8(_mm_subs_epu8(Difference, Limit), Zero);
+                Changed += 16 - FMath::CountBits(static_cast<uint64>(_mm_movemask_epi8(Over)));
+            }
+            alignas(16) uint64 Lanes[2];
+            _mm_store_si128(reinterpret_cast<__m128i*>(Lanes), SumVector);
+            Sum = Lanes[0] + Lanes[1];
+        }
+#elif NN_CHANGE_GATE_NEON
+        {
+            const uint8x16_t Limit = vdupq_n_u8(Threshold);
+            const uint8x16_t One = vdupq_n_u8(1);
+            uint32x4_t SumVector = vdupq_n_u32(0);
+            uint32x4_t ChangedVector = vdupq_n_u32(0);
+            for (; i + 16 <= NumBytes; i += 16)
+            {
+                const uint8x16_t Difference = vabdq_u8(vld1q_u8(A + i), vld1q_u8(B + i));
+                SumVector = vpadalq_u16(SumVector, vpaddlq_u8(Difference));
+                ChangedVector = vpadalq_u16(ChangedVector, vpaddlq_u8(vandq_u8(vcgtq_u8(Difference, Limit), One)));
+            }
+            Sum = vaddvq_u32(SumVector);
+            Changed = static_cast<int32>(vaddvq_u32(ChangedVector));
+        }
+#endif
+
+        for (; i < NumBytes; i++)
+        {
+            const int32 Difference = FMath::Abs(static_cast<int32>(A[i]) - static_cast<int32>(B[i]));
+            Sum += Difference;
+            Changed += Difference > Threshold ? 1 : 0;
+        }
+
+        OutSum = Sum;
+        OutChanged = Changed;
+    }
+}
+
+// ######################################################################################################################
+
+FNeuralNetworkChangeGate::FNeuralNetworkChangeGate(const FNeuralNetworkChangeGateSettings& InSettings)
+    : Settings(InSettings)
+{
+    Settings.SignatureSize = FMath::Clamp(Settings.SignatureSize, 4, 256);
+    Settings.CellThreshold = FMath::Clamp(Settings.CellThreshold, 0, 255);
+}
+
+/*
+- Parameters:
+ 1) Image: The incoming frame, before any preprocessing.
+- What it does: Computes the frame's signature and compares it with the reference. The frame is let through when
+  there is no reference yet, the image size changed, too many frames were skipped in a row, or either the mean
+  difference or the fraction of changed cells is over its threshold.
+- Return Value: bool, true when the network has to be run on this frame.
+*/
+bool FNeuralNetworkChangeGate::ShouldRun(const FNeuralNetworkImageView& Image)
+{
+    NEURAL_NETWORK_SCOPE(Preprocess);
+
+    ComputeSignature(Image, Current);
+    Stats.Checked++;
+
+    bool bRun = Reference.Num() != Current.Num() || ReferenceSize != FIntPoint(Image.Width, Image.Height)
+        || (Settings.MaxConsecutiveSkips > 0 && ConsecutiveSkips >= Settings.MaxConsecutiveSkips);
+
+    if (!bRun)
+    {
+        uint64 Sum = 0;
+        int32 Changed = 0;
+        NeuralNetworkChangeGate::CompareSignatures(Reference.GetData(), Current.GetData(), Current.Num(),
+            static_cast<uint8>(Settings.CellThreshold), Sum, Changed);
+
+        // The unused fourth byte of every cell is 0 in both signatures and never adds to the sum
+        const int32 NumChannels = (Current.Num() / 4) * 3;
+        Stats.LastMeanDifference = static_cast<float>(Sum) / NumChannels;
+        Stats.LastChangedFraction = static_cast<float>(Changed) / NumChannels;
+
+        bRun = Stats.LastMeanDifference > Settings.MeanThreshold || Stats.LastChangedFraction > Settings.MaxChangedFraction;
+    }
+
+    if (bRun)
+    {
+        Swap(Reference, Current);
+        ReferenceSize = FIntPoint(Image.Width, Image.Height);
+        ConsecutiveSkips = 0;
+    }
+    else
+    {
+        ConsecutiveSkips++;
+        Stats.Skipped++;
+    }
+
+    Stats.SkipRatio = static_cast<float>(static_cast<double>(Stats.Skipped) / Stats.Checked);
+    return bRun;
+}
+
+void FNeuralNetworkChangeGate::Reset()
+{
+    Reference.Reset();
+    ReferenceSize = FIntPoint::ZeroValue;
+    ConsecutiveSkips = 0;
+}
+
+FNeuralNetworkChangeGateStats FNeuralNetworkChangeGate::GetStats() const
+{
+    return Stats;
+}
+
+/*
+- Parameters:
+ 1) Image: The frame to reduce.
+ 2) OutSignature: Receives SignatureSize^2 cells of 4 bytes, the average of the first three channels of each cell.
+- What it does: Averages a sparse grid of point samples per cell, so the cost does not depend on the image resolution.
+  The channel order is left as is, both signatures of a comparison come from the same source.
+- Return Value: None.
+*/
+void FNeuralNetworkChangeGate::ComputeSignature(const FNeuralNetworkImageView& Image, TArray<uint8>& OutSignature) const
+{
+    using namespace NeuralNetworkChangeGate;
+
+    const int32 Size = Settings.SignatureSize;
+    OutSignature.SetNumUninitialized(Size * Size * 4, false);
+
+    if (!Image.Pixels || Image.Width < 1 || Image.Height < 1)
+    {
+        FMemory::Memzero(OutSignature.GetData(), OutSignature.Num());
+        return;
+    }
+
+    const int32 SamplesX = Size * SamplesPerCell;
+    const int32 SamplesY = Size * SamplesPerCell;
+    const int32 RowStride = Image.RowStride > 0 ? Image.RowStride : Image.Width * 4;
+
+    // Column byte offsets of the samples, shared by every row
+    TArray<int32, TInlineAllocator<1024>> Offsets;
+    Offsets.SetNumUninitialized(SamplesX);
+    for (int32 s = 0; s < SamplesX; s++)
+    {
+        Offsets[s] = FMath::Min(static_cast<int32>((s + 0.5f) * Image.Width / SamplesX), Image.Width - 1) * 4;
+    }
+
+    for (int32 CellY = 0; CellY < Size; CellY++)
+    {
+        uint32 Sums[256 * 3];
+        FMemory::Memzero(Sums, Size * 3 * sizeof(uint32));
+
+        for (int32 sy = 0; sy < SamplesPerCell; sy++)
+        {
+            const int32 SampleY = CellY * SamplesPerCell + sy;
+            const int32 Y = FMath::Min(static_cast<int32>((SampleY + 0.5f) * Image.Height / SamplesY), Image.Height - 1);
+            const uint8* Row = Image.Pixels + static_cast<int64>(Y) * RowStride;
+
+            for (int32 s = 0; s < SamplesX; s++)
+            {
+                const uint8* Pixel = Row + Offsets[s];
+                uint32* Cell = Sums + (s / SamplesPerCell) * 3;
+                Cell[0] += Pixel[0];
+                Cell[1] += Pixel[1];
+                Cell[2] += Pixel[2];
+            }
+        }
+
+        uint8* Out = OutSignature.GetData() + CellY * Size * 4;
+        for (int32 CellX = 0; CellX < Size; CellX++)
+        {
+            constexpr uint32 NumSamples = SamplesPerCell * SamplesPerCell;
+            Out[CellX * 4 + 0] = static_cast<uint8>(Sums[CellX * 3 + 0] / NumSamples);
+            Out[CellX * 4 + 1] = static_cast<uint8>(Sums[CellX * 3 + 1] / NumSamples);
+            Out[CellX * 4 + 2] = static_cast<uint8>(Sums[CellX * 3 + 2] / NumSamples);
+            Out[CellX * 4 + 3] = 0;
+        }
+    }
+}
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkPreprocess.h"
+
+#include "NeuralNetworkChangeGate.generated.h"
+
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkChangeGateSettings
+{
+    GENERATED_BODY()
+
+public:
+
+    // The frame is compared as a SignatureSize x SignatureSize grid of cell averages
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 SignatureSize = 64;
+
+    // Mean absolute difference per channel (0-255) over the whole signature below which a frame counts as unchanged
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float MeanThreshold = 2.0f;
+
+    // A cell channel differing by more than this (0-255) counts as changed, catches small moving objects the mean hides
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 CellThreshold = 24;
+
+    // Fraction of changed cell channels above which the frame is run regardless of the mean
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float MaxChangedFraction = 0.002f;
+
+    // Forces a run after this many skipped frames in a row so slow drift is picked up, 0 never forces one
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 MaxConsecutiveSkips = 30;
+};
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkChangeGateStats
+{
+    GENERATED_BODY()
+
+public:
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 Checked = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 Skipped = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    float SkipRatio = 0.0f;
+
+    // Difference of the last checked frame against the last frame that was run
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    float LastMeanDifference = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    float LastChangedFraction = 0.0f;
+};
+
+// Decides whether a frame differs enough from the last inferred frame to be worth running the network on.
+// Each frame is reduced to a small signature of cell averages which is compared with SIMD absolute differences
+// against the signature of the last frame that was let through. Not thread safe.
+class TUTORIAL_API FNeuralNetworkChangeGate
+{
+public:
+
+    explicit FNeuralNetworkChangeGate(const FNeuralNetworkChangeGateSettings& InSettings);
+
+    // True when the frame has to be run. The frame then becomes the reference the next frames are compared against.
+    bool ShouldRun(const FNeuralNetworkImageView& Image);
+
+    // Forgets the reference, the next frame is always run
+    void Reset();
+
+    FNeuralNetworkChangeGateStats GetStats() const;
+
+private:
+
+    void ComputeSignature(const FNeuralNetworkImageView& Image, TArray<uint8>& OutSignature) const;
+
+    FNeuralNetworkChangeGateSettings Settings;
+
+    // 4 bytes per cell, the byte that would hold alpha stays 0 in both signatures
+    TArray<uint8> Reference;
+    TArray<uint8> Current;
+    FIntPoint ReferenceSize = FIntPoint::ZeroValue;
+
+    int32 ConsecutiveSkips = 0;
+    FNeuralNetworkChangeGateStats Stats;
+};
@@ -0,0 +1,251 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkDetection.h"
+#include "NeuralNetworkStats.h"
+
+namespace NeuralNetworkDetection
+{
+    // Anchors processed per pass over the class rows, sized so the running maxima stay in L1
+    static constexpr int32 AnchorBlock = 256;
+
+    static void AddCandidate(const float* Output, int32 NumClasses, int32 NumAnchors, int32 Anchor, float BestScore,
+        const FNeuralNetworkLetterbox& Letterbox, TArray<FNeuralNetworkDetection>& OutDetections)
+    {
+        // The max pass already found the score, the class is the first row holding it
+        int32 BestClass = 0;
+        for (int32 c = 0; c < NumClasses; c++)
+        {
+            if (Output[(4 + c) * NumAnchors + Anchor] >= BestScore)
+            {
+                BestClass = c;
+                break;
+            }
+        }
+
+        const float CenterX = Output[0 * NumAnchors + Anchor];
+        const float CenterY = Output[1 * NumAnchors + Anchor];
+        const float HalfWidth = 0.5f * Output[2 * NumAnchors + Anchor];
+        const float HalfHeight = 0.5f * Output[3 * NumAnchors + Anchor];
+
+        // Undo the letterbox: tensor pixels -> source pixels
+        const float InvScale = 1.0f / Letterbox.Scale;
+        FNeuralNetworkDetection& Detection = OutDetections.AddDefaulted_GetRef();
+        Detection.Min.X = (CenterX - HalfWidth - Letterbox.PadX) * InvScale;
+        Detection.Min.Y = (CenterY - HalfHeight - Letterbox.PadY) * InvScale;
+        Detection.Max.X = (CenterX + HalfWidth - Letterbox.PadX) * InvScale;
+        Detection.Max.Y = (CenterY + HalfHeight - Letterbox.PadY) * InvScale;
+        Detection.ClassId = BestClass;
+        Detection.Score = BestScore;
+
+        if (Letterbox.SourceWidth > 0 && Letterbox.SourceHeight > 0)
+        {
+            const FVector2D SourceMax(Letterbox.SourceWidth, Letterbox.SourceHeight);
+            Detection.Min = FVector2D::Max(FVector2D::ZeroVector, FVector2D::Min(Detection.Min, SourceMax));
+            Detection.Max = FVector2D::Max(FVector2D::ZeroVector, FVector2D::Min(Detection.Max, SourceMax));
+        }
+    }
+
+    static void CellRange(const FNeuralNetworkDetection& Detection, const FVector2D& CellSize, int32 GridCells, FIntPoint& OutFirst, FIntPoint& OutLast)
+    {
+        OutFirst.X = FMath::Clamp(FMath::FloorToInt32(Detection.Min.X / CellSize.X), 0, GridCells - 1);
+        OutFirst.Y = FMath::Clamp(FMath::FloorToInt32(Detection.Min.Y / CellSize.Y), 0, GridCells - 1);
+        OutLast.X = FMath::Clamp(FMath::FloorToInt32(Detection.Max.X / CellSize.X), 0, GridCells - 1);
+        OutLast.Y = FMath::Clamp(FMath::FloorToInt32(Detection.Max.Y / CellSize.Y), 0, GridCells - 1);
+    }
+}
+
+// ######################################################################################################################
+
+/*
+- Parameters:
+ 1) A, B: The boxes to compare.
+- What it does: Computes the intersection over union of two axis aligned boxes.
+- Return Value: float in [0, 1].
+*/
+float NeuralNetworkDetection::IntersectionOverUnion(const FNeuralNetworkDetection& A, const FNeuralNetworkDetection& B)
+{
+    const double IntersectionWidth = FMath::Max(0.0, FMath::Min(A.Max.X, B.Max.X) - FMath::Max(A.Min.X, B.Min.X));
+    const double IntersectionHeight = FMath::Max(0.0, FMath::Min(A.Max.Y, B.Max.Y) - FMath::Max(A.Min.Y, B.Min.Y));
+    const double Intersection = IntersectionWidth * IntersectionHeight;
+    if (Intersection <= 0.0)
+    {
+        return 0.0f;
+    }
+
+    const double AreaA = (A.Max.X - A.Min.X) * (A.Max.Y - A.Min.Y);
+    const double AreaB = (B.Max.X - B.Min.X) * (B.Max.Y - B.Min.Y);
+    const double Union = AreaA + AreaB - Intersection;
+    return Union > 0.0 ? static_cast<float>(Intersection / Union) : 0.0f;
+}
+
+/*
+- Parameters:
+ 1) Output: The raw model output for one image, NumChannels x NumAnchors floats, channel major.
+ 2) NumChannels: 4 box channels plus one per class (84 for COCO).
+ 3) NumAnchors: Number of predictions (8400 for a 640x640 input).
+ 4) Letterbox: The mapping returned by the preprocessing of this image.
+ 5) Settings: Thresholds and limits.
+ 6) OutDetections: Receives at most Settings.MaxDetections detections, highest score first.
+- What it does: Takes the running max over the class rows four anchors at a time, so anchors below the threshold are
+  rejected without ever being transposed or argmaxed. Survivors are decoded, mapped back to the source image and
+  passed through NMS.
+- Return Value: bool indicating whether the output could be decoded.
+*/
+bool NeuralNetworkDetection::Decode(const float* Output, int32 NumChannels, int32 NumAnchors, const FNeuralNetworkLetterbox& Letterbox,
+    const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& OutDetections)
+{
+    NEURAL_NETWORK_SCOPE(Postprocess);
+
+    OutDetections.Reset();
+
+    const int32 NumClasses = NumChannels - 4;
+    if (!Output || NumClasses < 1 || NumAnchors < 1 || Letterbox.Scale <= 0.0f)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Decode failed: Invalid output (%d channels, %d anchors)"), NumChannels, NumAnchors);
+        return false;
+    }
+
+    const VectorRegister4Float Threshold = VectorSetFloat1(Settings.ScoreThreshold);
+    alignas(16) float BestScores[AnchorBlock];
+
+    for (int32 BlockStart = 0; BlockStart < NumAnchors; BlockStart += AnchorBlock)
+    {
+        const int32 BlockCount = FMath::Min(AnchorBlock, NumAnchors - BlockStart);
+        const int32 VectorCount = BlockCount & ~3;
+        const float* FirstClassRow = Output + 4 * NumAnchors + BlockStart;
+
+        FMemory::Memcpy(BestScores, FirstClassRow, BlockCount * sizeof(float));
+        for (int32 c = 1; c < NumClasses; c++)
+        {
+            const float* Row = FirstClassRow + c * NumAnchors;
+            int32 a = 0;
+            for (; a < VectorCount; a += 4)
+            {
+                VectorStoreAligned(VectorMax(VectorLoadAligned(BestScores + a), VectorLoad(Row + a)), BestScores + a);
+            }
+            for (; a < BlockCount; a++)
+            {
+                BestScores[a] = FMath::Max(BestScores[a], Row[a]);
+            }
+        }
+
+        for (int32 a = 0; a < BlockCount; a += 4)
+        {
+            uint32 Mask = 0;
+            if (a < VectorCount)
+            {
+                Mask = static_cast<uint32>(VectorMaskBits(VectorCompareGT(VectorLoadAligned(BestScores + a), Threshold)));
+            }
+            else
+            {
+                for (int32 Lane = 0; a + Lane < BlockCount; Lane++)
+                {
+                    Mask |= BestScores[a + Lane] > Settings.ScoreThreshold ? (1u << Lane) : 0u;
+                }
+            }
+
+            // Almost every group of four is empty and costs one compare
+            while (Mask != 0)
+            {
+                const int32 Lane = static_cast<int32>(FMath::CountTrailingZeros(Mask));
+                Mask &= Mask - 1;
+                AddCandidate(Output, NumClasses, NumAnchors, BlockStart + a + Lane, BestScores[a + Lane], Letterbox, OutDetections);
+            }
+        }
+    }
+
+    const FVector2D Extent = Letterbox.SourceWidth > 0 && Letterbox.SourceHeight > 0
+        ? FVector2D(Letterbox.SourceWidth, Letterbox.SourceHeight)
+        : FVector2D::ZeroVector;
+    NonMaxSuppression(OutDetections, Settings, Extent);
+
+    INC_DWORD_STAT_BY(STAT_NeuralNetwork_Detections, OutDetections.Num());
+    return true;
+}
+
+/*
+- Parameters:
+ 1) InOutDetections: Candidates in any order, replaced by the kept detections sorted by descending score.
+ 2) Settings: IoU threshold, detection cap, per class / agnostic mode and the grid layout.
+ 3) Extent: Size of the area the boxes live in. When zero, the bounds of the candidates are used.
+- What it does: Greedy NMS. With the grid enabled every kept box is registered in the cells it covers and a candidate
+  is only tested against the boxes registered in its own cells, which is exact since overlapping boxes share a cell.
+- Return Value: None.
+*/
+void NeuralNetworkDetection::NonMaxSuppression(TArray<FNeuralNetworkDetection>& InOutDetections, const FNeuralNetworkDecodeSettings& Settings, const FVector2D& Extent)
+{
+    if (InOutDetections.Num() == 0)
+    {
+        return;
+    }
+
+    InOutDetections.Sort([](const FNeuralNetworkDetection& A, const FNeuralNetworkDetection& B)
+    {
+        return A.Score > B.Score;
+    });
+
+    const int32 MaxDetections = Settings.MaxDetections > 0 ? Settings.MaxDetections : InOutDetections.Num();
+    const int32 GridCells = Settings.bUseGridNms ? FMath::Max(1, Settings.NmsGridCells) : 1;
+
+    FVector2D GridExtent = Extent;
+    if (GridExtent.X <= 0.0 || GridExtent.Y <= 0.0)
+    {
+        for (const FNeuralNetworkDetection& Detection : InOutDetections)
+        {
+            GridExtent = FVector2D::Max(GridExtent, Detection.Max);
+        }
+    }
+    const FVector2D CellSize(FMath::Max(GridExtent.X / GridCells, 1.0), FMath::Max(GridExtent.Y / GridCells, 1.0));
+
+    TArray<FNeuralNetworkDetection> Kept;
+    Kept.Reserve(FMath::Min(MaxDetections, InOutDetections.Num()));
+
+    TArray<TArray<int32, TInlineAllocator<8>>> Cells;
+    Cells.SetNum(GridCells * GridCells);
+
+    for (const FNeuralNetworkDetection& Candidate : InOutDetections)
+    {
+        FIntPoint First, Last;
+        CellRange(Candidate, CellSize, GridCells, First, Last);
+
+        bool bSuppressed = false;
+        for (int32 Y = First.Y; Y <= Last.Y && !bSuppressed; Y++)
+        {
+            for (int32 X = First.X; X <= Last.X && !bSuppressed; X++)
+            {
+                for (int32 KeptIndex : Cells[Y * GridCells + X])
+                {
+                    const FNeuralNetworkDetection& Other = Kept[KeptIndex];
+                    if ((Settings.bClassAgnosticNms || Other.ClassId == Candidate.ClassId)
+                        && IntersectionOverUnion(Other, Candidate) > Settings.IouThreshold)
+                    {
+                        bSuppressed = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (bSuppressed)
+        {
+            continue;
+        }
+
+        const int32 KeptIndex = Kept.Add(Candidate);
+        for (int32 Y = First.Y; Y <= Last.Y; Y++)
+        {
+            for (int32 X = First.X; X <= Last.X; X++)
+            {
+                Cells[Y * GridCells + X].Add(KeptIndex);
+            }
+        }
+
+        if (Kept.Num() >= MaxDetections)
+        {
+            break;
+        }
+    }
+
+    InOutDetections = MoveTemp(Kept);
+}
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkPreprocess.h"
+
+#include "NeuralNetworkDetection.generated.h"
+
+
+// One detected object, in source image pixels
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkDetection
+{
+    GENERATED_BODY()
+
+public:
+
+    UPROPERTY(BlueprintReadWrite, Category = "NNE - Tutorial")
+    FVector2D Min = FVector2D::ZeroVector;
+
+    UPROPERTY(BlueprintReadWrite, Category = "NNE - Tutorial")
+    FVector2D Max = FVector2D::ZeroVector;
+
+    UPROPERTY(BlueprintReadWrite, Category = "NNE - Tutorial")
+    int32 ClassId = INDEX_NONE;
+
+    UPROPERTY(BlueprintReadWrite, Category = "NNE - Tutorial")
+    float Score = 0.0f;
+
+    // Which image the box lives in, 0 for single view, 0 = left / 1 = right eye in stereo mode
+    UPROPERTY(BlueprintReadWrite, Category = "NNE - Tutorial")
+    int32 ViewIndex = 0;
+
+    // Stable per object id assigned by the tracker, INDEX_NONE for plain detections
+    UPROPERTY(BlueprintReadWrite, Category = "NNE - Tutorial")
+    int32 TrackId = INDEX_NONE;
+
+    // Class and score from the cascade's second stage classifier, INDEX_NONE when the box was not classified
+    UPROPERTY(BlueprintReadWrite, Category = "NNE - Tutorial")
+    int32 SubClassId = INDEX_NONE;
+
+    UPROPERTY(BlueprintReadWrite, Category = "NNE - Tutorial")
+    float SubClassScore = 0.0f;
+};
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkDecodeSettings
+{
+    GENERATED_BODY()
+
+public:
+
+    // Anchors whose best class score is not above this are dropped before NMS
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float ScoreThreshold = 0.25f;
+
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float IouThreshold = 0.45f;
+
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 MaxDetections = 100;
+
+    // Suppress overlapping boxes across classes instead of per class
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    bool bClassAgnosticNms = false;
+
+    // Bucket kept boxes into a NmsGridCells x NmsGridCells grid so each candidate is only tested against its neighbours
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    bool bUseGridNms = true;
+
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 NmsGridCells = 8;
+};
+
+namespace NeuralNetworkDetection
+{
+    // Decodes a channel major YOLOv8 output (4 box channels cx, cy, w, h followed by one score channel per class,
+    // each NumAnchors long) into detections in source image pixels. Runs NMS on the result.
+    TUTORIAL_API bool Decode(const float* Output, int32 NumChannels, int32 NumAnchors, const FNeuralNetworkLetterbox& Letterbox,
+        const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& OutDetections);
+
+    // Greedy NMS in place. Extent is the size of the area the boxes live in, used to lay out the grid.
+    TUTORIAL_API void NonMaxSuppression(TArray<FNeuralNetworkDetection>& InOutDetections, const FNeuralNetworkDecodeSettings& Settings, const FVector2D& Extent);
+
+    TUTORIAL_API float IntersectionOverUnion(const FNeuralNetworkDetection& A, const FNeuralNetworkDetection& B);
+}
@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkFoveation.h"
+#include "NeuralNetworkStats.h"
+
+#include "Algo/BinarySearch.h"
+#include "Misc/FileHelper.h"
+
+// ######################################################################################################################
+
+bool FNeuralNetworkFixedGazeSource::GetGaze(const FNeuralNetworkGazeQuery& Query, FVector2D& OutGaze)
+{
+    OutGaze = Gaze;
+    return true;
+}
+
+/*
+- Parameters:
+ 1) Query: Size of the frame, used for its aspect ratio.
+ 2) OutGaze: Receives the projected point.
+- What it does: Pinhole projection of the direction, with the vertical field of view derived from the horizontal one
+  and the frame aspect ratio.
+- Return Value: bool, false when the direction points behind the camera.
+*/
+bool FNeuralNetworkDirectionGazeSource::GetGaze(const FNeuralNetworkGazeQuery& Query, FVector2D& OutGaze)
+{
+    if (Direction.X <= UE_KINDA_SMALL_NUMBER || Query.FrameWidth < 1 || Query.FrameHeight < 1)
+    {
+        return false;
+    }
+
+    const double TanHalfHorizontal = FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(HorizontalFovDegrees, 1.0f, 179.0f) * 0.5));
+    const double TanHalfVertical = TanHalfHorizontal * Query.FrameHeight / Query.FrameWidth;
+
+    OutGaze.X = 0.5 + 0.5 * (Direction.Y / Direction.X) / TanHalfHorizontal;
+    OutGaze.Y = 0.5 - 0.5 * (Direction.Z / Direction.X) / TanHalfVertical;
+    return true;
+}
+
+/*
+- Parameters:
+ 1) FilePath: CSV file with "x,y" or "t,x,y" lines, normalized coordinates. Lines that do not parse are skipped.
+- What it does: Loads a gaze trace.
+- Return Value: The trace, or nullptr if the file could not be read or held no samples.
+*/
+TSharedPtr<FNeuralNetworkGazeTraceSource> FNeuralNetworkGazeTraceSource::LoadFromFile(const FString& FilePath)
+{
+    TArray<FString> Lines;
+    if (!FFileHelper::LoadFileToStringArray(Lines, *FilePath))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("LoadGazeTrace failed: Could not read %s"), *FilePath);
+        return nullptr;
+    }
+
+    TSharedPtr<FNeuralNetworkGazeTraceSource> Trace = MakeShared<FNeuralNetworkGazeTraceSource>();
+    bool bTimed = false;
+    for (const FString& Line : Lines)
+    {
+        TArray<FString> Fields;
+        Line.ParseIntoArray(Fields, TEXT(","));
+        if ((Fields.Num() != 2 && Fields.Num() != 3) || !Fields.Last().TrimStartAndEnd().IsNumeric())
+        {
+            continue;
+        }
+
+        const int32 First = Fields.Num() - 2;
+        if (Trace->Points.Num() == 0)
+        {
+            bTimed = Fields.Num() == 3;
+        }
+        if ((Fields.Num() == 3) != bTimed)
+        {
+            continue;
+        }
+
+        Trace->Times.Add(bTimed ? FCString::Atod(*Fields[0]) : Trace->Points.Num());
+        Trace->Points.Add(FVector2D(FCString::Atod(*Fields[First]), FCString::Atod(*Fields[First + 1])));
+    }
+
+    if (Trace->Points.Num() == 0)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("LoadGazeTrace failed: No samples in %s"), *FilePath);
+        return nullptr;
+    }
+
+    // Untimed traces advance one sample per frame
+    if (!bTimed)
+    {
+        Trace->Times.Reset();
+    }
+
+    UE_LOG(LogNeuralNetwork, Log, TEXT("LoadGazeTrace: %d %s samples from %s"), Trace->Points.Num(), bTimed ? TEXT("timed") : TEXT("per frame"), *FilePath);
+    return Trace;
+}
+
+/*
+- Parameters:
+ 1) Query: Frame number and time of the frame.
+ 2) OutGaze: Receives the sample for the frame.
+- What it does: Per frame traces return sample FrameNumber modulo the trace length. Timed traces are played from the
+  first query on, linearly interpolated and looped over their duration.
+- Return Value: bool, always true.
+*/
+bool FNeuralNetworkGazeTraceSource::GetGaze(const FNeuralNetworkGazeQuery& Query, FVector2D& OutGaze)
+{
+    if (Times.Num() == 0)
+    {
+        OutGaze = Points[static_cast<int32>(Query.FrameNumber % Points.Num())];
+        return true;
+    }
+
+    if (Times.Num() == 1)
+    {
+        OutGaze = Points[0];
+        return true;
+    }
+
+    if (StartTime < 0.0)
+    {
+        StartTime = Query.TimeSeconds;
+    }
+
+    const double Duration = Times.Last() - Times[0];
+    const double Time = Times[0] + (Duration > 0.0 ? FMath::Fmod(Query.TimeSeconds - StartTime, Duration) : 0.0);
+
+    const int32 Next = FMath::Clamp(Algo::UpperBound(Times, Time), 1, Times.Num() - 1);
+
+    const double Span = Times[Next] - Times[Next - 1];
+    const double Alpha = Span > 0.0 ? FMath::Clamp((Time - Times[Next - 1]) / Span, 0.0, 1.0) : 0.0;
+    OutGaze = FMath::Lerp(Points[Next - 1], Points[Next], Alpha);
+    return true;
+}
+
+// ######################################################################################################################
+
+/*
+- Parameters:
+ 1) FrameWidth, FrameHeight: Size of the source frame.
+ 2) Gaze: Normalized gaze point, clamped to the frame.
+ 3) CropSize: Side of the crop in source pixels.
+- What it does: Centers the crop on the gaze point and shifts it back inside the frame where it would stick out.
+- Return Value: FIntRect of the crop in source pixels.
+*/
+FIntRect NeuralNetworkFoveation::ComputeFoveaRect(int32 FrameWidth, int32 FrameHeight, const FVector2D& Gaze, int32 CropSize)
+{
+    const int32 Width = FMath::Clamp(CropSize, 1, FrameWidth);
+    const int32 Height = FMath::Clamp(CropSize, 1, FrameHeight);
+
+    const int32 CenterX = FMath::RoundToInt32(FMath::Clamp(Gaze.X, 0.0, 1.0) * FrameWidth);
+    const int32 CenterY = FMath::RoundToInt32(FMath::Clamp(Gaze.Y, 0.0, 1.0) * FrameHeight);
+
+    const int32 MinX = FMath::Clamp(CenterX - Width / 2, 0, FrameWidth - Width);
+    const int32 MinY = FMath::Clamp(CenterY - Height / 2, 0, FrameHeight - Height);
+    return FIntRect(MinX, MinY, MinX + Width, MinY + Height);
+}
@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkFoveation.generated.h"
+
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkFoveationSettings
+{
+    GENERATED_BODY()
+
+public:
+
+    // Side of the square crop around the gaze point in source pixels, equal to the model input size for native resolution
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 CropSize = 640;
+
+    // The whole frame is run every FullFrameInterval frames, the other frames reuse its detections outside the crop
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 FullFrameInterval = 4;
+};
+
+// What a gaze source gets to know about the frame it is asked about
+struct FNeuralNetworkGazeQuery
+{
+    uint64 FrameNumber = 0;
+    double TimeSeconds = 0.0;
+    int32 FrameWidth = 0;
+    int32 FrameHeight = 0;
+};
+
+// Supplies the point the user looks at, normalized to [0, 1] over the frame with (0, 0) at the top left.
+// Implementations are only called from the thread running the foveated detection.
+class TUTORIAL_API INeuralNetworkGazeSource
+{
+public:
+
+    virtual ~INeuralNetworkGazeSource() = default;
+
+    // Returns false when no gaze is known for the frame, the frame center is used then
+    virtual bool GetGaze(const FNeuralNetworkGazeQuery& Query, FVector2D& OutGaze) = 0;
+};
+
+// A gaze point set from outside, e.g. by Blueprint from an eye tracker sample
+class TUTORIAL_API FNeuralNetworkFixedGazeSource : public INeuralNetworkGazeSource
+{
+public:
+
+    explicit FNeuralNetworkFixedGazeSource(const FVector2D& InGaze) : Gaze(InGaze) {}
+
+    void SetGaze(const FVector2D& InGaze) { Gaze = InGaze; }
+
+    virtual bool GetGaze(const FNeuralNetworkGazeQuery& Query, FVector2D& OutGaze) override;
+
+private:
+
+    FVector2D Gaze;
+};
+
+// A view direction in the capture camera's space (X forward, Y right, Z up), e.g. the HMD forward vector, projected
+// through the camera's horizontal field of view
+class TUTORIAL_API FNeuralNetworkDirectionGazeSource : public INeuralNetworkGazeSource
+{
+public:
+
+    FNeuralNetworkDirectionGazeSource(const FVector& InDirection, float InHorizontalFovDegrees)
+        : Direction(InDirection), HorizontalFovDegrees(InHorizontalFovDegrees) {}
+
+    void SetDirection(const FVector& InDirection) { Direction = InDirection; }
+
+    virtual bool GetGaze(const FNeuralNetworkGazeQuery& Query, FVector2D& OutGaze) override;
+
+private:
+
+    FVector Direction;
+    float HorizontalFovDegrees;
+};
+
+// A recorded gaze trace played back in a loop, for headless runs and tests. Each line of the CSV file is either
+// "x,y" (one sample per frame) or "t,x,y" (seconds since the start of the trace).
+class TUTORIAL_API FNeuralNetworkGazeTraceSource : public INeuralNetworkGazeSource
+{
+public:
+
+    static TSharedPtr<FNeuralNetworkGazeTraceSource> LoadFromFile(const FString& FilePath);
+
+    virtual bool GetGaze(const FNeuralNetworkGazeQuery& Query, FVector2D& OutGaze) override;
+
+    int32 NumSamples() const { return Points.Num(); }
+
+private:
+
+    TArray<double> Times;
+    TArray<FVector2D> Points;
+
+    // Time of the first query, the trace starts playing from there
+    double StartTime = -1.0;
+};
+
+namespace NeuralNetworkFoveation
+{
+    // Square crop of CropSize centered on the gaze point, shifted to stay inside the frame and never larger than it
+    TUTORIAL_API FIntRect ComputeFoveaRect(int32 FrameWidth, int32 FrameHeight, const FVector2D& Gaze, int32 CropSize);
+}
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkFrameQueue.h"
+#include "NeuralNetworkStats.h"
+
+// ######################################################################################################################
+
+/*
+- Parameters:
+ 1) NumElements: Number of floats of one preprocessed input tensor.
+- What it does: Preallocates all slots so publishing and acquiring never allocate.
+- Return Value: None.
+*/
+void FNeuralNetworkFrameQueue::Allocate(int32 NumElements)
+{
+    for (FNeuralNetworkFrame& Frame : Slots)
+    {
+        Frame.Data.SetNumUninitialized(NumElements);
+    }
+}
+
+/*
+- Parameters: None.
+- What it does: Swaps the filled write slot with the latest slot. If the previous latest frame was never acquired it
+  is counted as dropped and its slot becomes the next write slot.
+- Return Value: uint64 frame number of the published frame, starting at 0.
+*/
+uint64 FNeuralNetworkFrameQueue::Publish()
+{
+    const uint64 FrameNumber = NumSubmitted.fetch_add(1, std::memory_order_relaxed);
+    Slots[WriteSlot].FrameNumber = FrameNumber;
+
+    const uint32 Previous = LatestSlot.exchange(static_cast<uint32>(WriteSlot) | FreshBit, std::memory_order_acq_rel);
+    if (Previous & FreshBit)
+    {
+        NumDropped.fetch_add(1, std::memory_order_relaxed);
+        INC_DWORD_STAT(STAT_NeuralNetwork_FramesDropped);
+    }
+    WriteSlot = static_cast<int32>(Previous & SlotMask);
+
+    return FrameNumber;
+}
+
+/*
+- Parameters: None.
+- What it does: Swaps the consumer's slot with the latest slot if it holds a fresh frame. Only the consumer clears
+  the fresh bit, so a fresh frame seen by the load is still there for the exchange.
+- Return Value: FNeuralNetworkFrame* to the newest frame, or nullptr when nothing new was published.
+*/
+FNeuralNetworkFrame* FNeuralNetworkFrameQueue::AcquireLatest()
+{
+    if (!(LatestSlot.load(std::memory_order_acquire) & FreshBit))
+    {
+        return nullptr;
+    }
+
+    const uint32 Previous = LatestSlot.exchange(static_cast<uint32>(ReadSlot), std::memory_order_acq_rel);
+    ReadSlot = static_cast<int32>(Previous & SlotMask);
+
+    NumProcessed.fetch_add(1, std::memory_order_relaxed);
+    return &Slots[ReadSlot];
+}
+
+bool FNeuralNetworkFrameQueue::HasPendingFrame() const
+{
+    return (LatestSlot.load(std::memory_order_acquire) & FreshBit) != 0;
+}
+
+/*
+- Parameters: None.
+- What it does: Reads the counters. They are updated independently, so a snapshot taken while frames are moving may
+  be off by one between the fields.
+- Return Value: FNeuralNetworkFrameQueueStats.
+*/
+FNeuralNetworkFrameQueueStats FNeuralNetworkFrameQueue::GetStats() const
+{
+    FNeuralNetworkFrameQueueStats Stats;
+    Stats.Submitted = static_cast<int64>(NumSubmitted.load(std::memory_order_relaxed));
+    Stats.Dropped = static_cast<int64>(NumDropped.load(std::memory_order_relaxed));
+    Stats.Processed = static_cast<int64>(NumProcessed.load(std::memory_order_relaxed));
+    return Stats;
+}
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkPreprocess.h"
+
+#include <atomic>
+
+#include "NeuralNetworkFrameQueue.generated.h"
+
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkFrameQueueStats
+{
+    GENERATED_BODY()
+
+public:
+
+    // Frames handed over by the capture side
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 Submitted = 0;
+
+    // Frames overwritten by a newer one before the inference worker picked them up
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 Dropped = 0;
+
+    // Frames picked up by the inference worker
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 Processed = 0;
+};
+
+// One preprocessed input tensor together with what is needed to interpret its result
+struct FNeuralNetworkFrame
+{
+    TArray<float> Data;
+    FNeuralNetworkLetterbox Letterbox;
+    uint64 FrameNumber = 0;
+    double CaptureTime = 0.0;
+};
+
+// Single producer / single consumer hand over of preprocessed frames where only the newest frame matters.
+// Three preallocated slots rotate between the producer, the consumer and the latest published frame, so neither
+// side ever waits for the other and no memory is allocated per frame. Publishing over a frame the consumer has
+// not taken yet drops it.
+class TUTORIAL_API FNeuralNetworkFrameQueue
+{
+public:
+
+    static constexpr int32 NumSlots = 3;
+
+    // Sizes every slot for NumElements floats. Not thread safe, call before the producer and consumer start.
+    void Allocate(int32 NumElements);
+
+    // Producer only: the slot to fill next, stays owned by the producer until Publish
+    FNeuralNetworkFrame& GetWriteFrame() { return Slots[WriteSlot]; }
+
+    // Producer only: makes the write slot the latest frame and returns the frame number it was given
+    uint64 Publish();
+
+    // Consumer only: takes the latest frame if one was published since the last call, otherwise returns nullptr.
+    // The frame stays valid until the next call.
+    FNeuralNetworkFrame* AcquireLatest();
+
+    // Any thread: whether AcquireLatest would return a frame right now
+    bool HasPendingFrame() const;
+
+    FNeuralNetworkFrameQueueStats GetStats() const;
+
+private:
+
+    // Set on LatestSlot while the frame in it has not been acquired
+    static constexpr uint32 FreshBit = 0x4;
+    static constexpr uint32 SlotMask = 0x3;
+
+    FNeuralNetworkFrame Slots[NumSlots];
+
+    // Owned by one side each, never touched by the other
+    int32 WriteSlot = 0;
+    int32 ReadSlot = 1;
+
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> LatestSlot{2};
+
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> NumSubmitted{0};
+    std::atomic<uint64> NumDropped{0};
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> NumProcessed{0};
+};
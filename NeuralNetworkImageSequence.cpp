@@ -0,0 +1,311 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkImageSequence.h"
+#include "NeuralNetworkStats.h"
+
+#include "Async/AsyncFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+
+// One frame from the start of its read until Next hands it out
+struct FNeuralNetworkImageSequenceReader::FSlot
+{
+    FNeuralNetworkSequenceFrame Frame;
+
+    IAsyncReadFileHandle* FileHandle = nullptr;
+    IAsyncReadRequest* ReadRequest = nullptr;
+    int64 FileSize = 0;
+
+    // Owned by the slot once the read completed, freed right after decoding
+    uint8* FileData = nullptr;
+
+    // Triggered by the read completion (or right away if the read could not start), releases DecodeTask
+    UE::Tasks::FTaskEvent ReadDone{ UE_SOURCE_LOCATION };
+    UE::Tasks::FTask DecodeTask;
+};
+
+// ######################################################################################################################
+
+/*
+- Parameters:
+ 1) Directory: The folder to list.
+- What it does: Lists the PNG and JPEG files of the folder, sorted by name so numbered frames stay in order.
+- Return Value: TArray<FString> of full paths.
+*/
+TArray<FString> FNeuralNetworkImageSequenceReader::FindFrames(const FString& Directory)
+{
+    TArray<FString> Names;
+    for (const TCHAR* Pattern : { TEXT("*.png"), TEXT("*.jpg"), TEXT("*.jpeg") })
+    {
+        TArray<FString> Found;
+        IFileManager::Get().FindFiles(Found, *(Directory / Pattern), true, false);
+        Names.Append(Found);
+    }
+    Names.Sort();
+
+    TArray<FString> Paths;
+    Paths.Reserve(Names.Num());
+    for (const FString& Name : Names)
+    {
+        Paths.Add(Directory / Name);
+    }
+    return Paths;
+}
+
+FNeuralNetworkImageSequenceReader::FNeuralNetworkImageSequenceReader(TArray<FString> InFiles, int32 InTargetWidth, int32 InTargetHeight, int32 InMaxFramesInFlight,
+    TSharedPtr<FNeuralNetworkTensorPool, ESPMode::ThreadSafe> InPool)
+    : Files(MoveTemp(InFiles))
+    , TargetWidth(InTargetWidth)
+    , TargetHeight(InTargetHeight)
+    , MaxFramesInFlight(FMath::Max(1, InMaxFramesInFlight))
+    , Pool(MoveTemp(InPool))
+{
+    check(Pool.IsValid());
+
+    // Loaded here, the decode tasks only use the module
+    ImageWrapperModule = &FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+
+    while (NextToIssue < Files.Num() && InFlight.Num() < MaxFramesInFlight)
+    {
+        Issue(NextToIssue++);
+    }
+}
+
+FNeuralNetworkImageSequenceReader::~FNeuralNetworkImageSequenceReader()
+{
+    for (const TSharedPtr<FSlot, ESPMode::ThreadSafe>& Slot : InFlight)
+    {
+        Slot->DecodeTask.Wait();
+        Finish(*Slot);
+    }
+}
+
+/*
+- Parameters:
+ 1) OutFrame: Receives the next frame. bValid is false if it could not be read or decoded.
+- What it does: Waits for the oldest frame in flight, hands it out and starts reading the next file so the number of
+  frames in flight stays at MaxFramesInFlight.
+- Return Value: bool, false once the sequence is exhausted.
+*/
+bool FNeuralNetworkImageSequenceReader::Next(FNeuralNetworkSequenceFrame& OutFrame)
+{
+    if (InFlight.Num() == 0)
+    {
+        return false;
+    }
+
+    TSharedPtr<FSlot, ESPMode::ThreadSafe> Slot = InFlight[0];
+    InFlight.RemoveAt(0, 1, false);
+
+    Slot->DecodeTask.Wait();
+    Finish(*Slot);
+    OutFrame = MoveTemp(Slot->Frame);
+
+    while (NextToIssue < Files.Num() && InFlight.Num() < MaxFramesInFlight)
+    {
+        Issue(NextToIssue++);
+    }
+    return true;
+}
+
+void FNeuralNetworkImageSequenceReader::Issue(int32 Index)
+{
+    TSharedPtr<FSlot, ESPMode::ThreadSafe> Slot = MakeShared<FSlot, ESPMode::ThreadSafe>();
+    Slot->Frame.Index = Index;
+    Slot->Frame.Path = Files[Index];
+    Slot->FileSize = IFileManager::Get().FileSize(*Slot->Frame.Path);
+
+    FSlot* SlotPtr = Slot.Get();
+    Slot->FileHandle = Slot->FileSize > 0 ? FPlatformFileManager::Get().GetPlatformFile().OpenAsyncRead(*Slot->Frame.Path) : nullptr;
+    if (Slot->FileHandle)
+    {
+        // May run on the I/O thread or inline, either way it only hands the memory over and releases the decode
+        FAsyncFileCallBack Callback = [SlotPtr](bool bWasCancelled, IAsyncReadRequest* Request)
+        {
+            if (!bWasCancelled)
+            {
+                SlotPtr->FileData = Request->GetReadResults();
+            }
+            SlotPtr->ReadDone.Trigger();
+        };
+        Slot->ReadRequest = Slot->FileHandle->ReadRequest(0, Slot->FileSize, AIOP_Normal, &Callback);
+    }
+    if (!Slot->ReadRequest)
+    {
+        Slot->ReadDone.Trigger();
+    }
+
+    IImageWrapperModule* Module = ImageWrapperModule;
+    FNeuralNetworkTensorPool* PoolPtr = Pool.Get();
+    const int32 Width = TargetWidth;
+    const int32 Height = TargetHeight;
+    Slot->DecodeTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [SlotPtr, Module, Width, Height, PoolPtr]()
+    {
+        Decode(*SlotPtr, *Module, Width, Height, *PoolPtr);
+    }, UE::Tasks::Prerequisites(Slot->ReadDone));
+
+    InFlight.Add(MoveTemp(Slot));
+}
+
+/*
+- Parameters:
+ 1) Slot: The frame, its file data has arrived (or failed to).
+ 2) ImageWrapperModule: Creates the decoder for the detected file format.
+ 3) TargetWidth, TargetHeight: Size of the tensor.
+ 4) Pool: Provides the tensor memory.
+- What it does: Decodes the file to RGBA8 and letterboxes it into a pooled tensor. Runs on the task graph, many frames
+  at once.
+- Return Value: None.
+*/
+void FNeuralNetworkImageSequenceReader::Decode(FSlot& Slot, IImageWrapperModule& ImageWrapperModule, int32 TargetWidth, int32 TargetHeight, FNeuralNetworkTensorPool& Pool)
+{
+    NEURAL_NETWORK_SCOPE(Preprocess);
+
+    if (!Slot.FileData)
+    {
+        UE_LOG(LogNeuralNetwork, Warning, TEXT("ImageSequence: Could not read %s"), *Slot.Frame.Path);
+        return;
+    }
+
+    TArray<uint8> Pixels;
+    const EImageFormat ImageFormat = ImageWrapperModule.DetectImageFormat(Slot.FileData, Slot.FileSize);
+    TSharedPtr<IImageWrapper> ImageWrapper = ImageFormat != EImageFormat::Invalid ? ImageWrapperModule.CreateImageWrapper(ImageFormat) : nullptr;
+    const bool bDecoded = ImageWrapper.IsValid()
+        && ImageWrapper->SetCompressed(Slot.FileData, Slot.FileSize)
+        && ImageWrapper->GetRaw(ERGBFormat::RGBA, 8, Pixels);
+
+    // The compressed file is not needed any more, keep the memory in flight bounded by the decoded frames
+    FMemory::Free(Slot.FileData);
+    Slot.FileData = nullptr;
+
+    if (!bDecoded)
+    {
+        UE_LOG(LogNeuralNetwork, Warning, TEXT("ImageSequence: Could not decode %s"), *Slot.Frame.Path);
+        return;
+    }
+
+    FNeuralNetworkImageView Image;
+    Image.Pixels = Pixels.GetData();
+    Image.Width = ImageWrapper->GetWidth();
+    Image.Height = ImageWrapper->GetHeight();
+    Image.RowStride = Image.Width * 4;
+    Image.Format = ENeuralNetworkPixelFormat::RGBA8;
+
+    Slot.Frame.Tensor = Pool.Acquire(3 * TargetWidth * TargetHeight);
+    Slot.Frame.bValid = Slot.Frame.Tensor.IsValid()
+        && NeuralNetworkPreprocess::Letterbox(Image, TargetWidth, TargetHeight, Slot.Frame.Tensor.GetData(), Slot.Frame.Letterbox);
+}
+
+void FNeuralNetworkImageSequenceReader::Finish(FSlot& Slot)
+{
+    if (Slot.ReadRequest)
+    {
+        Slot.ReadRequest->WaitCompletion();
+        delete Slot.ReadRequest;
+        Slot.ReadRequest = nullptr;
+    }
+
+    delete Slot.FileHandle;
+    Slot.FileHandle = nullptr;
+
+    if (Slot.FileData)
+    {
+        FMemory::Free(Slot.FileData);
+        Slot.FileData = nullptr;
+    }
+}
+
+// ######################################################################################################################
+
+FNeuralNetworkDetectionSink::~FNeuralNetworkDetectionSink()
+{
+    Close();
+}
+
+/*
+- Parameters:
+ 1) Path: The file to create, .csv writes CSV, anything else JSON lines.
+- What it does: Creates (or truncates) the file and writes the CSV header.
+- Return Value: bool indicating whether the file could be created.
+*/
+bool FNeuralNetworkDetectionSink::Open(const FString& Path)
+{
+    Close();
+
+    Writer.Reset(IFileManager::Get().CreateFileWriter(*Path));
+    if (!Writer.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectionSink: Could not create %s"), *Path);
+        return false;
+    }
+
+    bCsv = FPaths::GetExtension(Path).Equals(TEXT("csv"), ESearchCase::IgnoreCase);
+    if (bCsv)
+    {
+        WriteLine(TEXT("frame,path,class,score,min_x,min_y,max_x,max_y"));
+    }
+    return true;
+}
+
+/*
+- Parameters:
+ 1) FrameIndex, FramePath: The frame the detections belong to.
+ 2) Detections: The frame's detections, may be empty.
+- What it does: Appends one JSON line for the frame, or one CSV row per detection.
+- Return Value: None.
+*/
+void FNeuralNetworkDetectionSink::Write(int32 FrameIndex, const FString& FramePath, const TArray<FNeuralNetworkDetection>& Detections)
+{
+    if (!Writer.IsValid())
+    {
+        return;
+    }
+
+    if (bCsv)
+    {
+        const FString QuotedPath = TEXT("\"") + FramePath.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+        for (const FNeuralNetworkDetection& Detection : Detections)
+        {
+            WriteLine(FString::Printf(TEXT("%d,%s,%d,%.4f,%.1f,%.1f,%.1f,%.1f"), FrameIndex, *QuotedPath, Detection.ClassId, Detection.Score,
+                Detection.Min.X, Detection.Min.Y, Detection.Max.X, Detection.Max.Y));
+        }
+        return;
+    }
+
+    FString Line = FString::Printf(TEXT("{\"frame\": %d, \"path\": \"%s\", \"detections\": ["), FrameIndex, *FramePath.ReplaceCharWithEscapedChar());
+    for (int32 i = 0; i < Detections.Num(); i++)
+    {
+        const FNeuralNetworkDetection& Detection = Detections[i];
+        Line += FString::Printf(TEXT("%s{\"class\": %d, \"score\": %.4f, \"box\": [%.1f, %.1f, %.1f, %.1f]}"), i > 0 ? TEXT(", ") : TEXT(""),
+            Detection.ClassId, Detection.Score, Detection.Min.X, Detection.Min.Y, Detection.Max.X, Detection.Max.Y);
+    }
+    Line += TEXT("]}");
+    WriteLine(Line);
+}
+
+void FNeuralNetworkDetectionSink::Close()
+{
+    if (Writer.IsValid())
+    {
+        Writer->Close();
+        Writer.Reset();
+    }
+}
+
+void FNeuralNetworkDetectionSink::WriteLine(const FString& Line)
+{
+    FTCHARToUTF8 Utf8(*(Line + TEXT("\n")));
+    Writer->Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+
+    // Flush now and then so the file can be followed while a long run is going on
+    if (++LinesSinceFlush >= 64)
+    {
+        Writer->Flush();
+        LinesSinceFlush = 0;
+    }
+}
@@ -0,0 +1,142 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkDetection.h"
+#include "NeuralNetworkPreprocess.h"
+#include "NeuralNetworkTensorPool.h"
+#include "Tasks/Task.h"
+
+#include "NeuralNetworkImageSequence.generated.h"
+
+class IImageWrapperModule;
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkImageSequenceSettings
+{
+    GENERATED_BODY()
+
+public:
+
+    // Folder of PNG / JPEG frames, processed in file name order. Ignored when Files is not empty.
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    FString Directory;
+
+    // Explicit frame list, processed in this order
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    TArray<FString> Files;
+
+    // Detections are appended to this file as they come in, one JSON object per frame for .jsonl, one row per box
+    // for .csv. Empty writes nothing.
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    FString OutputPath;
+
+    // Frames per inference, falls back to 1 if the model has no dynamic batch dimension
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 BatchSize = 8;
+
+    // Frames being read or decoded ahead of the inference, bounds the memory to about this many decoded frames
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 MaxFramesInFlight = 16;
+};
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkImageSequenceStats
+{
+    GENERATED_BODY()
+
+public:
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 Frames = 0;
+
+    // Frames that could not be read or decoded, they are skipped
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 FailedFrames = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 Detections = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    float Seconds = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    float FramesPerSecond = 0.0f;
+
+    // Time the inference side waited for a frame, close to Seconds means the run is I/O or decode bound
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    float WaitSeconds = 0.0f;
+};
+
+// One frame of the sequence, decoded and letterboxed into a pooled 1x3xHxW tensor
+struct FNeuralNetworkSequenceFrame
+{
+    int32 Index = INDEX_NONE;
+    FString Path;
+    bool bValid = false;
+    FNeuralNetworkTensorPool::FBuffer Tensor;
+    FNeuralNetworkLetterbox Letterbox;
+};
+
+// Streams an image sequence through read, decode and letterbox. Up to MaxFramesInFlight frames are in flight at once:
+// the file is read with async file I/O and its completion releases a decode task on the task graph. Next hands the
+// frames out strictly in order. Use from one thread; create it on the game thread, which loads the image module.
+class TUTORIAL_API FNeuralNetworkImageSequenceReader
+{
+public:
+
+    // Sorted image files of a folder
+    static TArray<FString> FindFrames(const FString& Directory);
+
+    FNeuralNetworkImageSequenceReader(TArray<FString> InFiles, int32 InTargetWidth, int32 InTargetHeight, int32 InMaxFramesInFlight,
+        TSharedPtr<FNeuralNetworkTensorPool, ESPMode::ThreadSafe> InPool);
+    ~FNeuralNetworkImageSequenceReader();
+
+    // Waits for the next frame in order. Returns false once every frame has been handed out.
+    bool Next(FNeuralNetworkSequenceFrame& OutFrame);
+
+    int32 Num() const { return Files.Num(); }
+
+private:
+
+    struct FSlot;
+
+    void Issue(int32 Index);
+    static void Decode(FSlot& Slot, IImageWrapperModule& ImageWrapperModule, int32 TargetWidth, int32 TargetHeight, FNeuralNetworkTensorPool& Pool);
+    static void Finish(FSlot& Slot);
+
+    TArray<FString> Files;
+    int32 TargetWidth = 0;
+    int32 TargetHeight = 0;
+    int32 MaxFramesInFlight = 1;
+    TSharedPtr<FNeuralNetworkTensorPool, ESPMode::ThreadSafe> Pool;
+    IImageWrapperModule* ImageWrapperModule = nullptr;
+
+    // Frames in flight, oldest first
+    TArray<TSharedPtr<FSlot, ESPMode::ThreadSafe>> InFlight;
+    int32 NextToIssue = 0;
+};
+
+// Appends detections to a .jsonl or .csv file frame by frame, so a long run can be inspected (or resumed) at any time
+class TUTORIAL_API FNeuralNetworkDetectionSink
+{
+public:
+
+    ~FNeuralNetworkDetectionSink();
+
+    bool Open(const FString& Path);
+    void Write(int32 FrameIndex, const FString& FramePath, const TArray<FNeuralNetworkDetection>& Detections);
+    void Close();
+
+    bool IsOpen() const { return Writer.IsValid(); }
+
+private:
+
+    void WriteLine(const FString& Line);
+
+    TUniquePtr<FArchive> Writer;
+    bool bCsv = false;
+    int32 LinesSinceFlush = 0;
+};
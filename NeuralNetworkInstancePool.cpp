@@ -0,0 +1,225 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkInstancePool.h"
+#include "NeuralNetworkStats.h"
+
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
+
+// ######################################################################################################################
+
+/*
+- Parameters:
+ 1) Model: The shared CPU model the instances are created from.
+ 2) PoolSize: Number of instances, each can run one inference at a time.
+- What it does: Creates PoolSize instances of the model, all sharing the model weights.
+- Return Value: The pool, or nullptr if an instance could not be created.
+*/
+TSharedPtr<FNeuralNetworkInstancePool, ESPMode::ThreadSafe> FNeuralNetworkInstancePool::Create(const TSharedPtr<UE::NNE::IModelCPU>& Model, int32 PoolSize)
+{
+    if (!Model.IsValid() || PoolSize < 1)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("FNeuralNetworkInstancePool::Create failed: Invalid model or pool size %d"), PoolSize);
+        return nullptr;
+    }
+
+    TSharedPtr<FNeuralNetworkInstancePool, ESPMode::ThreadSafe> Pool = MakeShareable(new FNeuralNetworkInstancePool());
+    Pool->Model = Model;
+    Pool->Slots.SetNum(PoolSize);
+    Pool->FreeSlots.Reserve(PoolSize);
+
+    for (int32 i = 0; i < PoolSize; i++)
+    {
+        Pool->Slots[i].Instance = Model->CreateModelInstanceCPU();
+        if (!Pool->Slots[i].Instance.IsValid())
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("FNeuralNetworkInstancePool::Create failed: Could not create instance %d"), i);
+            return nullptr;
+        }
+
+        // Pop from the back hands out slot 0 first
+        Pool->FreeSlots.Add(PoolSize - 1 - i);
+    }
+
+    Pool->SlotReleasedEvent = FPlatformProcess::GetSynchEventFromPool(false);
+
+    UE_LOG(LogNeuralNetwork, Log, TEXT("FNeuralNetworkInstancePool: Created %d model instances"), PoolSize);
+    return Pool;
+}
+
+FNeuralNetworkInstancePool::~FNeuralNetworkInstancePool()
+{
+    if (SlotReleasedEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(SlotReleasedEvent);
+        SlotReleasedEvent = nullptr;
+    }
+}
+
+/*
+- Parameters:
+ 1) WaitMilliseconds: How long to wait for an instance when all of them are busy.
+- What it does: Checks out a free instance for exclusive use by the calling thread.
+- Return Value: FLease, invalid if no instance became free in time.
+*/
+FNeuralNetworkInstancePool::FLease FNeuralNetworkInstancePool::Acquire(uint32 WaitMilliseconds)
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    for (;;)
+    {
+        {
+            FScopeLock Lock(&FreeSlotsLock);
+            if (FreeSlots.Num() > 0)
+            {
+                FLease Lease;
+                Lease.Pool = AsShared();
+                Lease.SlotIndex = FreeSlots.Pop(false);
+                return Lease;
+            }
+        }
+
+        if (WaitMilliseconds == 0)
+        {
+            return FLease();
+        }
+
+        uint32 RemainingMilliseconds = MAX_uint32;
+        if (WaitMilliseconds != MAX_uint32)
+        {
+            const double ElapsedMilliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+            if (ElapsedMilliseconds >= WaitMilliseconds)
+            {
+                return FLease();
+            }
+            RemainingMilliseconds = WaitMilliseconds - static_cast<uint32>(ElapsedMilliseconds);
+        }
+
+        SlotReleasedEvent->Wait(RemainingMilliseconds);
+    }
+}
+
+/*
+- Parameters: None.
+- What it does: Counts the instances that are not checked out right now.
+- Return Value: int32 number of free instances.
+*/
+int32 FNeuralNetworkInstancePool::NumAvailable() const
+{
+    FScopeLock Lock(&FreeSlotsLock);
+    return FreeSlots.Num();
+}
+
+void FNeuralNetworkInstancePool::ReleaseSlot(int32 SlotIndex)
+{
+    {
+        FScopeLock Lock(&FreeSlotsLock);
+        check(!FreeSlots.Contains(SlotIndex));
+        FreeSlots.Add(SlotIndex);
+    }
+    SlotReleasedEvent->Trigger();
+}
+
+// ######################################################################################################################
+
+FNeuralNetworkInstancePool::FLease::FLease(FLease&& Other)
+    : Pool(MoveTemp(Other.Pool))
+    , SlotIndex(Other.SlotIndex)
+{
+    Other.SlotIndex = INDEX_NONE;
+}
+
+FNeuralNetworkInstancePool::FLease& FNeuralNetworkInstancePool::FLease::operator=(FLease&& Other)
+{
+    if (this != &Other)
+    {
+        Release();
+        Pool = MoveTemp(Other.Pool);
+        SlotIndex = Other.SlotIndex;
+        Other.SlotIndex = INDEX_NONE;
+    }
+    return *this;
+}
+
+FNeuralNetworkInstancePool::FLease::~FLease()
+{
+    Release();
+}
+
+FNeuralNetworkInstancePool::FSlot& FNeuralNetworkInstancePool::FLease::GetSlot() const
+{
+    check(IsValid());
+    return Pool->Slots[SlotIndex];
+}
+
+void FNeuralNetworkInstancePool::FLease::Release()
+{
+    if (IsValid())
+    {
+        Pool->ReleaseSlot(SlotIndex);
+    }
+    Pool.Reset();
+    SlotIndex = INDEX_NONE;
+}
+
+/*
+- Parameters:
+ 1) Shapes: Concrete shapes of the inputs.
+- What it does: Prepares the leased instance for the shapes, only when they changed since it was last prepared.
+  Its output shapes are concrete afterwards.
+- Return Value: bool indicating whether the instance accepted the shapes.
+*/
+bool FNeuralNetworkInstancePool::FLease::Prepare(TConstArrayView<UE::NNE::FTensorShape> Shapes) const
+{
+    using namespace UE::NNE;
+
+    FSlot& Slot = GetSlot();
+
+    bool bShapesChanged = Slot.InputShapes.Num() != Shapes.Num();
+    for (int32 i = 0; !bShapesChanged && i < Shapes.Num(); i++)
+    {
+        bShapesChanged = !(Slot.InputShapes[i] == Shapes[i]);
+    }
+
+    if (bShapesChanged)
+    {
+        if (Slot.Instance->SetInputTensorShapes(Shapes) != EResultStatus::Ok)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("FNeuralNetworkInstancePool: Could not set input tensor shapes on instance %d"), SlotIndex);
+            Slot.InputShapes.Reset();
+            return false;
+        }
+        Slot.InputShapes.Reset();
+        Slot.InputShapes.Append(Shapes.GetData(), Shapes.Num());
+    }
+    return true;
+}
+
+/*
+- Parameters:
+ 1) Shapes: Concrete shapes of the inputs.
+ 2) Inputs, Outputs: Caller owned memory of the input and output tensors.
+- What it does: Prepares the leased instance for the shapes (only when they changed since its last run) and runs it.
+- Return Value: bool indicating whether the inference was successful.
+*/
+bool FNeuralNetworkInstancePool::FLease::Run(TConstArrayView<UE::NNE::FTensorShape> Shapes, TConstArrayView<UE::NNE::FTensorBindingCPU> Inputs, TConstArrayView<UE::NNE::FTensorBindingCPU> Outputs) const
+{
+    using namespace UE::NNE;
+
+    NEURAL_NETWORK_SCOPE(Run);
+
+    if (!Prepare(Shapes))
+    {
+        return false;
+    }
+
+    if (GetSlot().Instance->RunSync(Inputs, Outputs) != EResultStatus::Ok)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("FNeuralNetworkInstancePool: Model execution returned an error on instance %d"), SlotIndex);
+        return false;
+    }
+
+    INC_DWORD_STAT(STAT_NeuralNetwork_Inferences);
+    return true;
+}
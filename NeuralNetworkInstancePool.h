@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NNE.h"
+#include "NNERuntimeCPU.h"
+
+
+// A fixed number of model instances created from one shared IModelCPU, so several threads can run inference
+// at the same time without loading the weights more than once. Instances are handed out as move-only leases.
+class TUTORIAL_API FNeuralNetworkInstancePool : public TSharedFromThis<FNeuralNetworkInstancePool, ESPMode::ThreadSafe>
+{
+public:
+
+    // One instance together with the bindings and the shapes last set on it
+    struct FSlot
+    {
+        TSharedPtr<UE::NNE::IModelInstanceCPU> Instance;
+        TArray<UE::NNE::FTensorBindingCPU> InputBindings;
+        TArray<UE::NNE::FTensorBindingCPU> OutputBindings;
+        TArray<UE::NNE::FTensorShape> InputShapes;
+    };
+
+    // Exclusive use of one slot, the slot goes back to the pool when the lease is destroyed
+    class TUTORIAL_API FLease
+    {
+    public:
+        FLease() = default;
+        FLease(FLease&& Other);
+        FLease& operator=(FLease&& Other);
+        FLease(const FLease&) = delete;
+        FLease& operator=(const FLease&) = delete;
+        ~FLease();
+
+        bool IsValid() const { return Pool.IsValid() && SlotIndex != INDEX_NONE; }
+        FSlot& GetSlot() const;
+        void Release();
+
+        // Sets the input shapes if they differ from the ones the instance is prepared for
+        bool Prepare(TConstArrayView<UE::NNE::FTensorShape> Shapes) const;
+
+        // Prepare, then runs synchronously
+        bool Run(TConstArrayView<UE::NNE::FTensorShape> Shapes, TConstArrayView<UE::NNE::FTensorBindingCPU> Inputs, TConstArrayView<UE::NNE::FTensorBindingCPU> Outputs) const;
+
+    private:
+        friend class FNeuralNetworkInstancePool;
+
+        TSharedPtr<FNeuralNetworkInstancePool, ESPMode::ThreadSafe> Pool;
+        int32 SlotIndex = INDEX_NONE;
+    };
+
+    static TSharedPtr<FNeuralNetworkInstancePool, ESPMode::ThreadSafe> Create(const TSharedPtr<UE::NNE::IModelCPU>& Model, int32 PoolSize);
+
+    ~FNeuralNetworkInstancePool();
+
+    // Waits up to WaitMilliseconds for a free instance, 0 fails fast and MAX_uint32 waits forever.
+    // The returned lease is invalid when every instance stayed busy.
+    FLease Acquire(uint32 WaitMilliseconds);
+
+    int32 Num() const { return Slots.Num(); }
+    int32 NumAvailable() const;
+
+private:
+
+    FNeuralNetworkInstancePool() = default;
+
+    void ReleaseSlot(int32 SlotIndex);
+
+    TSharedPtr<UE::NNE::IModelCPU> Model;
+    TArray<FSlot> Slots;
+
+    mutable FCriticalSection FreeSlotsLock;
+    TArray<int32> FreeSlots;
+
+    // Triggered once per released slot to wake a waiting Acquire
+    FEvent* SlotReleasedEvent = nullptr;
+};
@@ -4,6 +4,7 @@
 
 
 #include "NeuralNetworkModel.h"
+#include "NeuralNetworkStats.h"
 
 ///*
 #include "IImageWrapperModule.h"
@@ -15,13 +16,123 @@
 #include "Engine/TextureRenderTarget2D.h"
 #include "Engine/Texture2D.h"
 //#include "Rendering/TextureRenderTargetResource.h"
+#include "TextureResource.h"
 #include "Kismet/KismetRenderingLibrary.h"
 
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Tasks/Task.h"
+#include "UObject/StrongObjectPtr.h"
+
+#include <atomic>
+
 //*/
 
 // Fixed Input Shape for YOLOv8
 const TArray<int32> FIXED_INPUT_SHAPE = {1, 3, 640, 640};
 
+// Everything a RunAsync worker touches. Shared with the worker so it stays valid even if the UNeuralNetworkModel is destroyed mid run.
+struct FNeuralNetworkAsyncRun
+{
+    TArray<TArray<float>> InputData;
+    TArray<UE::NNE::FTensorBindingCPU> InputBindings;
+    TArray<FNeuralNetworkTensor> Outputs;
+    TArray<UE::NNE::FTensorBindingCPU> OutputBindings;
+
+    // Set when the owner is destroyed, the worker skips the run and the result is never broadcast
+    std::atomic<bool> bCancelled{false};
+
+    // True while the worker task has not returned yet
+    std::atomic<bool> bWorkerActive{false};
+};
+
+// Everything the SubmitFrame worker touches, shared with it for the same reason as FNeuralNetworkAsyncRun
+struct FNeuralNetworkFramePipeline
+{
+    FNeuralNetworkFrameQueue Queue;
+
+    TSharedPtr<UE::NNE::IModelCPU> Model;
+    TSharedPtr<UE::NNE::IModelInstanceCPU> Instance;
+    int32 InputWidth = 0;
+    int32 InputHeight = 0;
+
+    // Output 0 is decoded as NumChannels x NumAnchors, the other outputs are only bound
+    TArray<TArray<float>> OutputData;
+    TArray<UE::NNE::FTensorBindingCPU> OutputBindings;
+    int32 NumChannels = 0;
+    int32 NumAnchors = 0;
+
+    FNeuralNetworkDecodeSettings Settings;
+
+    // Set by StopFramePipeline or the owner's destruction, the worker returns after its current frame
+    std::atomic<bool> bStopped{false};
+
+    // True while a worker task is draining the queue, at most one exists at a time
+    std::atomic<bool> bWorkerActive{false};
+};
+
+/*
+- Parameters:
+ 1) Pipeline: The pipeline to drain, bWorkerActive must have been set by the caller.
+ 2) WeakOwner: Receives the results on the game thread if it is still alive.
+- What it does: Runs and decodes the latest frame until the queue has nothing new, then clears bWorkerActive. Frames
+  published while a run is going on replace each other, only the newest one is run next.
+- Return Value: None.
+*/
+static void DrainFramePipeline(const TSharedPtr<FNeuralNetworkFramePipeline, ESPMode::ThreadSafe>& Pipeline, const TWeakObjectPtr<UNeuralNetworkModel>& WeakOwner)
+{
+    using namespace UE::NNE;
+
+    for (;;)
+    {
+        while (!Pipeline->bStopped)
+        {
+            const FNeuralNetworkFrame* Frame = Pipeline->Queue.AcquireLatest();
+            if (!Frame)
+            {
+                break;
+            }
+
+            const FTensorBindingCPU InputBinding{ const_cast<float*>(Frame->Data.GetData()), Frame->Data.Num() * sizeof(float) };
+
+            bool bSuccess = false;
+            {
+                NEURAL_NETWORK_SCOPE(Run);
+                bSuccess = Pipeline->Instance->RunSync(MakeArrayView(&InputBinding, 1), Pipeline->OutputBindings) == EResultStatus::Ok;
+                INC_DWORD_STAT(STAT_NeuralNetwork_Inferences);
+            }
+
+            TArray<FNeuralNetworkDetection> Detections;
+            if (bSuccess)
+            {
+                bSuccess = NeuralNetworkDetection::Decode(Pipeline->OutputData[0].GetData(), Pipeline->NumChannels, Pipeline->NumAnchors,
+                    Frame->Letterbox, Pipeline->Settings, Detections);
+            }
+
+            const int64 FrameNumber = static_cast<int64>(Frame->FrameNumber);
+            UE_LOG(LogNeuralNetwork, Verbose, TEXT("Frame %lld processed %.1f ms after capture"), FrameNumber, (FPlatformTime::Seconds() - Frame->CaptureTime) * 1000.0);
+
+            AsyncTask(ENamedThreads::GameThread, [WeakOwner, Pipeline, FrameNumber, bSuccess, Detections = MoveTemp(Detections)]()
+            {
+                UNeuralNetworkModel* This = WeakOwner.Get();
+                if (!This || Pipeline->bStopped)
+                {
+                    return;
+                }
+                This->OnFrameProcessed.Broadcast(FrameNumber, bSuccess, Detections);
+            });
+        }
+
+        Pipeline->bWorkerActive = false;
+
+        // A frame published between the last AcquireLatest and clearing the flag did not start a worker, take it here
+        if (Pipeline->bStopped || !Pipeline->Queue.HasPendingFrame() || Pipeline->bWorkerActive.exchange(true))
+        {
+            return;
+        }
+    }
+}
+
 // ######################################################################################################################
 
 /*
@@ -31,15 +142,15 @@ const TArray<int32> FIXED_INPUT_SHAPE = {1, 3, 640, 640};
 */
 TArray<FString> UNeuralNetworkModel::GetRuntimeNames()
 {
-    UE_LOG(LogTemp, Log, TEXT("Fetching available runtime names"));
+    UE_LOG(LogNeuralNetwork, Log, TEXT("Fetching available runtime names"));
 
     TArray<FString> RuntimeNames = UE::NNE::GetAllRuntimeNames();
 
-    UE_LOG(LogTemp, Warning, TEXT("Number of runtimes found: %d"), RuntimeNames.Num());
+    UE_LOG(LogNeuralNetwork, Log, TEXT("Number of runtimes found: %d"), RuntimeNames.Num());
     // Log the names of the available runtimes
     for (const FString& RuntimeName : RuntimeNames)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Available runtime: %s"), *RuntimeName);
+        UE_LOG(LogNeuralNetwork, Log, TEXT("Available runtime: %s"), *RuntimeName);
     }
 
     return RuntimeNames;
@@ -52,338 +163,3349 @@ TArray<FString> UNeuralNetworkModel::GetRuntimeNames()
 - Parameters:
  1) Parent: The parent UObject for the model instance.
  2) RuntimeName: The name of the runtime to use (e.g., "NNERuntimeORTCpu").
- 3) ModelData: The ONNX model data loaded as a UNNEModelData asset.
+ 3) ModelData: The ONNX model data loaded as a UNNEModelData asset, /Game/yolov8n is loaded when null.
 - What it does: Creates and initializes a neural network model instance using the specified runtime and model data.
+  The model itself comes from FNeuralNetworkModelCache, so every object created for the same asset and runtime
+  shares one copy of the weights and only owns its own model instance.
 - Return Value: UNeuralNetworkModel* pointing to the created model instance, or nullptr if creation fails.
  */
 UNeuralNetworkModel* UNeuralNetworkModel::CreateModel(UObject* Parent, FString RuntimeName, UNNEModelData* ModelData)
 {
     using namespace UE::NNE;
 
-    // Explicitly set the desired runtime
-    RuntimeName = "NNERuntimeORTCpu";
-    
     // Load ModelData from Unreal's asset system
-    ModelData = LoadObject<UNNEModelData>(nullptr, TEXT("/Game/yolov8n"));
     if (!ModelData)
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to load ONNX model data."));
+        ModelData = LoadObject<UNNEModelData>(nullptr, TEXT("/Game/yolov8n"));
+    }
+    if (!ModelData)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Failed to load ONNX model data."));
         return nullptr;
     }
 
-    TWeakInterfacePtr<INNERuntimeCPU> Runtime = GetRuntime<INNERuntimeCPU>(RuntimeName);
-    if (!Runtime.IsValid())
+    TSharedPtr<UE::NNE::IModelCPU> UniqueModel;
+    RuntimeName = SelectRuntimeName(RuntimeName, ModelData, UniqueModel);
+    if (RuntimeName.IsEmpty())
     {
-        UE_LOG(LogTemp, Error, TEXT("No CPU runtime '%s' found"), *RuntimeName);
         return nullptr;
     }
-    UE_LOG(LogTemp, Warning, TEXT("Creating model using runtime: %s"), *RuntimeName);
 
-    TSharedPtr<UE::NNE::IModelCPU> UniqueModel = Runtime->CreateModelCPU(ModelData);
+    UE_LOG(LogNeuralNetwork, Log, TEXT("Creating model using runtime: %s"), *RuntimeName);
+
+    if (!UniqueModel.IsValid())
+    {
+        UniqueModel = FNeuralNetworkModelCache::Get().FindOrCreate(ModelData, RuntimeName);
+    }
     if (!UniqueModel.IsValid())
     {
-        UE_LOG(LogTemp, Error, TEXT("Could not create the CPU model"));
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Could not create the CPU model"));
+        return nullptr;
+    }
+    UE_LOG(LogNeuralNetwork, Log, TEXT("Created model using runtime: %s"), *RuntimeName);
+
+    // Create a new instance of UNeuralNetworkModel
+    UNeuralNetworkModel* Result = NewObject<UNeuralNetworkModel>(Parent);
+    if (!Result)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Failed to create UNeuralNetworkModel instance."));
+        return nullptr;
+    }
+
+    UE_LOG(LogNeuralNetwork, Log, TEXT("Successfully created UNeuralNetworkModel instance."));
+    
+    if (UniqueModel.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Verbose, TEXT("Model is valid after creation."));
+    }
+    else
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Model is NOT valid after creation."));
+    }
+
+    // Store the model in the created instance
+    Result->Model = UniqueModel;
+
+    // Store the ModelInstance by creating a new instance from the model
+    Result->ModelInstance = UniqueModel->CreateModelInstanceCPU();
+    if (!Result->ModelInstance.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Failed to create ModelInstance."));
+        return nullptr;
+    }
+
+    UE_LOG(LogNeuralNetwork, Log, TEXT("ModelInstance successfully created and stored in UNeuralNetworkModel."));
+
+    return Result;
+}
+
+
+
+/*
+- Parameters:
+ 1) Parent, RuntimeName, ModelData: Same as CreateModel.
+ 2) NumWarmupRuns: Dummy inferences run on the fixed input shape before the model reports ready.
+- What it does: Returns the object immediately and builds the model, its instance and the input shape plan on a
+  background task, then runs the warm-up inferences there so graph optimization, arena setup and first touch page
+  faults are paid off the game thread. OnModelReady is broadcast on the game thread when done.
+- Return Value: UNeuralNetworkModel* that becomes usable once OnModelReady fires (until then its accessors log an error
+  and return empty results), or nullptr if the model data is missing.
+ */
+UNeuralNetworkModel* UNeuralNetworkModel::CreateModelAsync(UObject* Parent, FString RuntimeName, UNNEModelData* ModelData, int32 NumWarmupRuns)
+{
+    using namespace UE::NNE;
+
+    check(IsInGameThread());
+
+    // Asset loading has to stay on the game thread
+    if (!ModelData)
+    {
+        ModelData = LoadObject<UNNEModelData>(nullptr, TEXT("/Game/yolov8n"));
+    }
+    if (!ModelData)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Failed to load ONNX model data."));
+        return nullptr;
+    }
+
+    UNeuralNetworkModel* Result = NewObject<UNeuralNetworkModel>(Parent);
+    if (!Result)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Failed to create UNeuralNetworkModel instance."));
         return nullptr;
     }
-    UE_LOG(LogTemp, Warning, TEXT("Created model using runtime: %s"), *RuntimeName);
 
-    // Create a new instance of UNeuralNetworkModel
-    UNeuralNetworkModel* Result = NewObject<UNeuralNetworkModel>(Parent);
-    if (!Result)
+    TWeakObjectPtr<UNeuralNetworkModel> WeakResult(Result);
+    TStrongObjectPtr<UNNEModelData> KeepModelData(ModelData);
+
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakResult, KeepModelData, RuntimeName, NumWarmupRuns]() mutable
+    {
+        const double StartTime = FPlatformTime::Seconds();
+
+        // Selecting "Auto" may benchmark every runtime, which is exactly what should not run on the game thread
+        TSharedPtr<IModelCPU> NewModel;
+        RuntimeName = SelectRuntimeName(RuntimeName, KeepModelData.Get(), NewModel);
+        UE_LOG(LogNeuralNetwork, Log, TEXT("Creating model asynchronously using runtime: %s"), *RuntimeName);
+
+        if (!NewModel.IsValid() && !RuntimeName.IsEmpty())
+        {
+            NewModel = FNeuralNetworkModelCache::Get().FindOrCreate(KeepModelData.Get(), RuntimeName);
+        }
+        TSharedPtr<IModelInstanceCPU> NewInstance = NewModel.IsValid() ? NewModel->CreateModelInstanceCPU() : nullptr;
+
+        TArray<FTensorShape> PreparedShapes;
+        const bool bSuccess = NewInstance.IsValid() && WarmUpInstance(*NewInstance, NumWarmupRuns, PreparedShapes);
+        const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+        AsyncTask(ENamedThreads::GameThread, [WeakResult, KeepModelData = MoveTemp(KeepModelData), NewModel = MoveTemp(NewModel),
+            NewInstance = MoveTemp(NewInstance), PreparedShapes = MoveTemp(PreparedShapes), bSuccess, Seconds]() mutable
+        {
+            UNeuralNetworkModel* This = WeakResult.Get();
+            if (!This)
+            {
+                return;
+            }
+
+            if (bSuccess)
+            {
+                This->Model = MoveTemp(NewModel);
+                This->ModelInstance = MoveTemp(NewInstance);
+                This->InputShapes = MoveTemp(PreparedShapes);
+                UE_LOG(LogNeuralNetwork, Log, TEXT("CreateModelAsync: Model ready and warmed up after %.1f ms"), Seconds * 1000.0);
+            }
+            else
+            {
+                UE_LOG(LogNeuralNetwork, Error, TEXT("CreateModelAsync: Could not create or warm up the model"));
+            }
+
+            This->OnModelReady.Broadcast(bSuccess);
+        });
+    });
+
+    return Result;
+}
+
+/*
+- Parameters:
+ 1) Instance: A freshly created model instance.
+ 2) NumRuns: Number of dummy inferences.
+ 3) OutShapes: Receives the input shapes the instance was prepared for.
+ 4) OutMeanMilliseconds: Optional, receives the mean time of the runs after the first one.
+- What it does: Prepares the instance for its default input shapes and runs it on grey inputs, so the first real
+  inference does not pay for the runtime's lazy initialization. Also used to time runtimes against each other.
+  Safe to call from any thread.
+- Return Value: bool indicating whether the instance was prepared and all warm-up runs succeeded.
+ */
+bool UNeuralNetworkModel::WarmUpInstance(UE::NNE::IModelInstanceCPU& Instance, int32 NumRuns, TArray<UE::NNE::FTensorShape>& OutShapes, double* OutMeanMilliseconds)
+{
+    using namespace UE::NNE;
+
+    TConstArrayView<FTensorDesc> InputDescs = Instance.GetInputTensorDescs();
+    OutShapes.Reset();
+    for (int32 i = 0; i < InputDescs.Num(); i++)
+    {
+        const TArray<int32> Shape = ResolveSymbolicShape(InputDescs[i].GetShape().GetData(), i == 0 ? FIXED_INPUT_SHAPE : TArray<int32>());
+        OutShapes.Add(FTensorShape::MakeFromSymbolic(FSymbolicTensorShape::Make(Shape)));
+    }
+
+    if (Instance.SetInputTensorShapes(OutShapes) != EResultStatus::Ok)
+    {
+        OutShapes.Reset();
+        return false;
+    }
+
+    TArray<TArray<float>> InputData, OutputData;
+    TArray<FTensorBindingCPU> Inputs, Outputs;
+    for (const FTensorShape& Shape : OutShapes)
+    {
+        TArray<float>& Data = InputData.AddDefaulted_GetRef();
+        Data.Init(NeuralNetworkPreprocess::PadValue, static_cast<int32>(Shape.Volume()));
+        Inputs.Add(FTensorBindingCPU{ Data.GetData(), Data.Num() * sizeof(float) });
+    }
+    for (const FTensorShape& Shape : Instance.GetOutputTensorShapes())
+    {
+        TArray<float>& Data = OutputData.AddDefaulted_GetRef();
+        Data.SetNumUninitialized(static_cast<int32>(Shape.Volume()));
+        Outputs.Add(FTensorBindingCPU{ Data.GetData(), Data.Num() * sizeof(float) });
+    }
+
+    double TimedSeconds = 0.0;
+    for (int32 Run = 0; Run < NumRuns; Run++)
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        if (Instance.RunSync(Inputs, Outputs) != EResultStatus::Ok)
+        {
+            return false;
+        }
+        if (Run > 0)
+        {
+            TimedSeconds += FPlatformTime::Seconds() - StartTime;
+        }
+    }
+
+    if (OutMeanMilliseconds)
+    {
+        *OutMeanMilliseconds = NumRuns > 1 ? TimedSeconds * 1000.0 / (NumRuns - 1) : 0.0;
+    }
+    return true;
+}
+
+/*
+- Parameters:
+ 1) RequestedRuntimeName: The runtime name the caller passed in, "Auto" or empty to pick one.
+ 2) ModelData: The model that will be created.
+ 3) OutSelectedModel: Receives the winner's model when the selection benchmarked the runtimes, left empty otherwise.
+- What it does: Picks the runtime CreateModel / CreateModelAsync actually use. A CPU runtime asked for by name is used
+  as is, otherwise the fastest one for the model on this machine is selected (measured once, then cached).
+- Return Value: FString runtime name, empty if no runtime can run the model.
+ */
+FString UNeuralNetworkModel::SelectRuntimeName(const FString& RequestedRuntimeName, UNNEModelData* ModelData, TSharedPtr<UE::NNE::IModelCPU>& OutSelectedModel)
+{
+    if (!NeuralNetworkRuntimeSelection::IsAuto(RequestedRuntimeName))
+    {
+        if (UE::NNE::GetRuntime<INNERuntimeCPU>(RequestedRuntimeName).IsValid())
+        {
+            return RequestedRuntimeName;
+        }
+        UE_LOG(LogNeuralNetwork, Warning, TEXT("No CPU runtime '%s' found, selecting one automatically"), *RequestedRuntimeName);
+    }
+
+    return NeuralNetworkRuntimeSelection::SelectRuntime(ModelData, false, &OutSelectedModel);
+}
+
+/*
+- Parameters: None.
+- What it does: Reports the runtime the automatic selection picked last and the timings it was based on.
+- Return Value: FNeuralNetworkRuntimeSelection, empty if no automatic selection happened yet.
+ */
+FNeuralNetworkRuntimeSelection UNeuralNetworkModel::GetRuntimeSelection()
+{
+    return NeuralNetworkRuntimeSelection::GetLastSelection();
+}
+
+/*
+- Parameters: None.
+- What it does: Reports whether the model and its instance exist, i.e. CreateModel succeeded or CreateModelAsync finished.
+- Return Value: bool, true once the object can be used.
+ */
+bool UNeuralNetworkModel::IsReady() const
+{
+    return Model.IsValid() && ModelInstance.IsValid();
+}
+
+/*
+- Parameters: None.
+- What it does: Reports how often CreateModel reused an already loaded model and the memory that saved.
+- Return Value: FNeuralNetworkModelCacheStats snapshot.
+ */
+FNeuralNetworkModelCacheStats UNeuralNetworkModel::GetModelCacheStats()
+{
+    return FNeuralNetworkModelCache::Get().GetStats();
+}
+
+// ######################################################################################################################
+
+/*
+- Parameters:
+ 1) Shape: The shape of the tensor as a TArray<int32>.
+ 2) Tensor: A reference to a FNeuralNetworkTensor to be populated.
+- What it does: Allocates memory for a tensor with the specified shape and initializes its data array.
+- Return Value: bool indicating whether the tensor was successfully created.
+ */
+bool UNeuralNetworkModel::CreateTensor(TArray<int32> Shape, UPARAM(ref) FNeuralNetworkTensor& Tensor)
+{
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("CreateTensor called with shape: %s"), *FString::JoinBy(Shape, TEXT(", "), [](int32 Val) { return FString::FromInt(Val); }));
+
+    if (Shape.Num() == 0)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("CreateTensor failed: Shape array is empty"));
+        return false;
+    }
+
+    int32 Volume = 1;
+    for (int32 i = 0; i < Shape.Num(); i++)
+    {
+        if (Shape[i] < 1)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("CreateTensor failed: Invalid shape value at index %d (value: %d)"), i, Shape[i]);
+            return false;
+        }
+        Volume *= Shape[i];
+    }
+
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("CreateTensor: Allocating tensor with volume %d"), Volume);
+
+    Tensor.Shape = Shape;
+    Tensor.Data.SetNum(Volume);
+
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("CreateTensor: Successfully created tensor."));
+    return true;
+}
+
+/*
+- Parameters:
+ 1) Output: A raw YOLOv8 output tensor, 1 x (4 + NumClasses) x NumAnchors.
+ 2) Letterbox: The mapping returned by PreprocessPixels for the image that produced this output.
+ 3) Settings: Score / IoU thresholds and the maximum number of detections.
+ 4) Detections: Receives the detections in source image pixels, highest score first.
+- What it does: Filters, decodes and NMS-es the output natively so Blueprint only sees the final boxes.
+- Return Value: bool indicating whether the output could be decoded.
+ */
+bool UNeuralNetworkModel::DecodeDetections(const FNeuralNetworkTensor& Output, const FNeuralNetworkLetterbox& Letterbox, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    return DecodeOutput(Output.Shape, Output.Data, Letterbox, Settings, Detections);
+}
+
+/*
+- Parameters:
+ 1) Shape, Data: The raw YOLOv8 output, from a tensor or a tensor handle.
+ 2) Letterbox, Settings, Detections: Same as DecodeDetections.
+- What it does: Shared implementation of DecodeDetections and DecodeDetectionsHandle.
+- Return Value: bool indicating whether the output could be decoded.
+ */
+bool UNeuralNetworkModel::DecodeOutput(TConstArrayView<int32> Shape, TConstArrayView<float> Data, const FNeuralNetworkLetterbox& Letterbox,
+    const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    // Without a shape assume the 84 channels (4 box + 80 COCO classes) of the stock YOLOv8 export
+    const int32 NumChannels = Shape.Num() >= 2 ? Shape[Shape.Num() - 2] : 84;
+    const int32 NumAnchors = Shape.Num() >= 2 ? Shape.Last() : Data.Num() / NumChannels;
+
+    if (NumChannels * NumAnchors > Data.Num())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DecodeDetections failed: Output holds %d elements, expected %d x %d"), Data.Num(), NumChannels, NumAnchors);
+        return false;
+    }
+
+    return NeuralNetworkDetection::Decode(Data.GetData(), NumChannels, NumAnchors, Letterbox, Settings, Detections);
+}
+
+/*
+- Parameters:
+ 1) Pixels: Interleaved 8-bit pixels as returned by LoadPNGToPixelArray / ProcessScreenshot.
+ 2) Width, Height: Size of the image in pixels.
+ 3) Format: Byte order of the pixels (RGBA8 for PNG data, BGRA8 for FColor data).
+ 4) Tensor: The NCHW input tensor to fill. Its shape is kept if it is 1x3xHxW, otherwise it is set to the fixed YOLOv8 shape.
+ 5) Letterbox: Receives the scale and padding needed to map detected boxes back to the source image.
+- What it does: Letterboxes, channel splits and normalizes the image into the input tensor in one native pass.
+  The PNG path (LoadPNGToPixelArray / ProcessScreenshot) is kept for offline use, live frames should use
+  PreprocessColors / PreprocessRenderTarget / PreprocessImage instead.
+- Return Value: bool indicating whether the tensor was filled.
+ */
+bool UNeuralNetworkModel::PreprocessPixels(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format, UPARAM(ref) FNeuralNetworkTensor& Tensor, FNeuralNetworkLetterbox& Letterbox)
+{
+    if (Width < 1 || Height < 1 || Pixels.Num() < Width * Height * 4)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("PreprocessPixels failed: %d bytes do not hold a %dx%d image"), Pixels.Num(), Width, Height);
+        return false;
+    }
+
+    FNeuralNetworkImageView Image;
+    Image.Pixels = Pixels.GetData();
+    Image.Width = Width;
+    Image.Height = Height;
+    Image.RowStride = Width * 4;
+    Image.Format = Format;
+
+    return PreprocessImage(Image, Tensor, Letterbox);
+}
+
+/*
+- Parameters:
+ 1) Colors: Pixels already in memory, e.g. from a viewport or scene capture readback. FColor is BGRA8.
+ 2) Width, Height: Size of the image in pixels.
+ 3) Tensor, Letterbox: Same as PreprocessPixels.
+- What it does: Feeds in-memory frames straight into the preprocessing, no PNG encode / decode or file I/O involved.
+- Return Value: bool indicating whether the tensor was filled.
+ */
+bool UNeuralNetworkModel::PreprocessColors(const TArray<FColor>& Colors, int32 Width, int32 Height, UPARAM(ref) FNeuralNetworkTensor& Tensor, FNeuralNetworkLetterbox& Letterbox)
+{
+    if (Width < 1 || Height < 1 || Colors.Num() < Width * Height)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("PreprocessColors failed: %d pixels do not hold a %dx%d image"), Colors.Num(), Width, Height);
+        return false;
+    }
+
+    FNeuralNetworkImageView Image;
+    Image.Pixels = reinterpret_cast<const uint8*>(Colors.GetData());
+    Image.Width = Width;
+    Image.Height = Height;
+    Image.RowStride = Width * sizeof(FColor);
+    Image.Format = ENeuralNetworkPixelFormat::BGRA8;
+
+    return PreprocessImage(Image, Tensor, Letterbox);
+}
+
+/*
+- Parameters:
+ 1) RenderTarget: The render target to read, e.g. the target of a USceneCaptureComponent2D.
+ 2) Tensor, Letterbox: Same as PreprocessPixels.
+- What it does: Reads the render target back into this model's staging buffer and preprocesses the pixels directly.
+  ReadPixels waits for the render thread, call it from the game thread only.
+- Return Value: bool indicating whether the tensor was filled.
+ */
+bool UNeuralNetworkModel::PreprocessRenderTarget(UTextureRenderTarget2D* RenderTarget, UPARAM(ref) FNeuralNetworkTensor& Tensor, FNeuralNetworkLetterbox& Letterbox)
+{
+    check(IsInGameThread());
+
+    if (!RenderTarget)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("PreprocessRenderTarget failed: RenderTarget is null!"));
+        return false;
+    }
+
+    FTextureRenderTargetResource* RenderTargetResource = RenderTarget->GameThread_GetRenderTargetResource();
+    if (!RenderTargetResource)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("PreprocessRenderTarget failed: Failed to get render target resource!"));
+        return false;
+    }
+
+    if (!RenderTargetResource->ReadPixels(ReadbackPixels) || ReadbackPixels.Num() == 0)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("PreprocessRenderTarget failed: Failed to read pixel data!"));
+        return false;
+    }
+
+    return PreprocessColors(ReadbackPixels, RenderTarget->SizeX, RenderTarget->SizeY, Tensor, Letterbox);
+}
+
+/*
+- Parameters:
+ 1) Image: Non-owning view of the source pixels, any row stride.
+ 2) Tensor: The NCHW input tensor to fill. Its shape is kept if it is 1x3xHxW, otherwise it is set to the fixed YOLOv8 shape.
+ 3) Letterbox: Receives the scale and padding needed to map detected boxes back to the source image.
+- What it does: Shared implementation of the Preprocess* functions.
+- Return Value: bool indicating whether the tensor was filled.
+ */
+bool UNeuralNetworkModel::PreprocessImage(const FNeuralNetworkImageView& Image, FNeuralNetworkTensor& Tensor, FNeuralNetworkLetterbox& Letterbox)
+{
+    const bool bHasImageShape = Tensor.Shape.Num() == 4 && Tensor.Shape[0] == 1 && Tensor.Shape[1] == 3 && Tensor.Shape[2] > 0 && Tensor.Shape[3] > 0;
+    if (!bHasImageShape)
+    {
+        Tensor.Shape = FIXED_INPUT_SHAPE;
+    }
+
+    const int32 TargetHeight = Tensor.Shape[2];
+    const int32 TargetWidth = Tensor.Shape[3];
+    Tensor.Data.SetNumUninitialized(3 * TargetWidth * TargetHeight, false);
+
+    return NeuralNetworkPreprocess::Letterbox(Image, TargetWidth, TargetHeight, Tensor.Data.GetData(), Letterbox);
+}
+
+/*
+ - Parameters: None.
+ - What it does: Returns the number of input tensors expected by the model.
+ - Return Value: int32 representing the number of input tensors.
+ */
+int32 UNeuralNetworkModel::NumInputs()
+{
+    if (!Model.IsValid() || !ModelInstance.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("NumInputs failed: Model instance is invalid, the model may still be loading"));
+        return 0;
+    }
+    int32 Num = ModelInstance->GetInputTensorDescs().Num();
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("NumInputs called: %d inputs found"), Num);
+    return Num;
+}
+
+/*
+ - Parameters: None.
+ - What it does: Returns the number of output tensors produced by the model.
+ - Return Value: int32 representing the number of output tensors.
+ */
+int32 UNeuralNetworkModel::NumOutputs()
+{
+    if (!Model.IsValid() || !ModelInstance.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("NumOutputs failed: Model instance is invalid, the model may still be loading"));
+        return 0;
+    }
+    int32 Num = ModelInstance->GetOutputTensorDescs().Num();
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("NumOutputs called: %d outputs found"), Num);
+    return Num;
+}
+
+/*
+ - Parameters:
+    1) Index: The index of the input tensor.
+ - What it does: Returns the shape the model instance is prepared for. Before any input was set, the shape is read
+   from the model's tensor desc and its symbolic (-1) dimensions are resolved against the fixed YOLOv8 input shape.
+ - Return Value: TArray<int32> representing the input tensor shape, empty if the index is out of bounds.
+ */
+TArray<int32> UNeuralNetworkModel::GetInputShape(int32 Index)
+{
+    if (!Model.IsValid() || !ModelInstance.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("GetInputShape failed: Model instance is invalid, the model may still be loading"));
+        return TArray<int32>();
+    }
+
+    using namespace UE::NNE;
+
+    TConstArrayView<FTensorDesc> Desc = ModelInstance->GetInputTensorDescs();
+    if (Index < 0 || Index >= Desc.Num())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("GetInputShape failed: Index %d out of bounds"), Index);
+        return TArray<int32>();
+    }
+
+    TArray<int32> Shape;
+    if (InputShapes.IsValidIndex(Index))
+    {
+        for (uint32 Dim : InputShapes[Index].GetData())
+        {
+            Shape.Add(static_cast<int32>(Dim));
+        }
+    }
+    else
+    {
+        Shape = ResolveSymbolicShape(Desc[Index].GetShape().GetData(), Index == 0 ? FIXED_INPUT_SHAPE : TArray<int32>());
+    }
+
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("GetInputShape called for index %d: Shape = %s"), Index, *FString::JoinBy(Shape, TEXT(", "), [](int32 Val) { return FString::FromInt(Val); }));
+    return Shape;
+}
+
+/*
+ - Parameters:
+    1) Index: The index of the output tensor.
+ - What it does: Returns the concrete output shape (1x84x8400 for a 640x640 YOLOv8n). If the instance was not prepared
+   yet it is prepared for the shapes returned by GetInputShape first, since output shapes are only known after that.
+ - Return Value: TArray<int32> representing the output tensor shape, empty if the index is out of bounds.
+ */
+TArray<int32> UNeuralNetworkModel::GetOutputShape(int32 Index)
+{
+    if (!Model.IsValid() || !ModelInstance.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("GetOutputShape failed: Model instance is invalid, the model may still be loading"));
+        return TArray<int32>();
+    }
+
+    using namespace UE::NNE;
+
+    TConstArrayView<FTensorDesc> Desc = ModelInstance->GetOutputTensorDescs();
+    if (Index < 0 || Index >= Desc.Num())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("GetOutputShape failed: Index %d out of bounds"), Index);
+        return TArray<int32>();
+    }
+
+    if (InputShapes.Num() == 0 && !bRunInFlight)
+    {
+        TArray<FTensorShape, TInlineAllocator<4>> DefaultShapes;
+        for (int32 i = 0; i < ModelInstance->GetInputTensorDescs().Num(); i++)
+        {
+            DefaultShapes.Add(FTensorShape::MakeFromSymbolic(FSymbolicTensorShape::Make(GetInputShape(i))));
+        }
+        ApplyInputShapes(DefaultShapes);
+    }
+
+    TArray<int32> Shape;
+    TConstArrayView<FTensorShape> OutputShapes = ModelInstance->GetOutputTensorShapes();
+    if (OutputShapes.IsValidIndex(Index))
+    {
+        for (uint32 Dim : OutputShapes[Index].GetData())
+        {
+            Shape.Add(static_cast<int32>(Dim));
+        }
+    }
+    else
+    {
+        Shape = ResolveSymbolicShape(Desc[Index].GetShape().GetData(), TArray<int32>());
+    }
+
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("GetOutputShape called for index %d: Shape = %s"), Index, *FString::JoinBy(Shape, TEXT(", "), [](int32 Val) { return FString::FromInt(Val); }));
+    return Shape;
+}
+
+/*
+ - Parameters:
+    1) SymbolicShape: Dimensions from a tensor desc, -1 marks a dimension only known at run time.
+    2) Fallback: Values for the symbolic dimensions, used when it has the same rank.
+ - What it does: Replaces every symbolic dimension by its fallback value, or by 1 when there is none.
+ - Return Value: TArray<int32> concrete shape.
+ */
+TArray<int32> UNeuralNetworkModel::ResolveSymbolicShape(TConstArrayView<int32> SymbolicShape, const TArray<int32>& Fallback)
+{
+    TArray<int32> Shape;
+    Shape.Reserve(SymbolicShape.Num());
+    for (int32 i = 0; i < SymbolicShape.Num(); i++)
+    {
+        if (SymbolicShape[i] >= 0)
+        {
+            Shape.Add(SymbolicShape[i]);
+        }
+        else
+        {
+            Shape.Add(Fallback.Num() == SymbolicShape.Num() ? Fallback[i] : 1);
+        }
+    }
+    return Shape;
+}
+
+/*
+ - Parameters:
+    1) CacheSize: How many instances prepared for other input shapes to keep around, 0 disables the cache.
+ - What it does: Bounds the per shape cache used when the input resolution changes, evicting the least recently used
+   entries if it shrinks.
+ - Return Value: None.
+ */
+void UNeuralNetworkModel::SetShapeCacheSize(int32 CacheSize)
+{
+    MaxPreparedInstances = FMath::Max(0, CacheSize);
+
+    while (PreparedInstances.Num() > MaxPreparedInstances)
+    {
+        int32 Oldest = 0;
+        for (int32 i = 1; i < PreparedInstances.Num(); i++)
+        {
+            if (PreparedInstances[i].LastUsed < PreparedInstances[Oldest].LastUsed)
+            {
+                Oldest = i;
+            }
+        }
+        PreparedInstances.RemoveAtSwap(Oldest);
+    }
+}
+
+/*
+ - Parameters:
+    1) Shape: The shape of the tensor as a TArray<int32>.
+    2) Tensor: Receives the shape and uninitialized data; storage it already holds goes back to the pool first.
+ - What it does: CreateTensor without the allocation. The data comes from storage an earlier ReleaseTensor of the
+   same size handed back, so a tensor acquired and released every frame stops allocating after the first frame.
+ - Return Value: bool indicating whether the tensor was created.
+ */
+bool UNeuralNetworkModel::AcquireTensor(TArray<int32> Shape, UPARAM(ref) FNeuralNetworkTensor& Tensor)
+{
+    int64 Volume = Shape.Num() > 0 ? 1 : 0;
+    for (int32 i = 0; i < Shape.Num(); i++)
+    {
+        if (Shape[i] < 1)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("AcquireTensor failed: Invalid shape value at index %d (value: %d)"), i, Shape[i]);
+            return false;
+        }
+        Volume *= Shape[i];
+    }
+
+    if (Volume < 1 || Volume > MAX_int32)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("AcquireTensor failed: Shape has %lld elements"), Volume);
+        return false;
+    }
+
+    GetTensorPool()->AcquireArray(static_cast<int32>(Volume), Tensor.Data);
+    Tensor.Shape = MoveTemp(Shape);
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Tensor: The tensor to release, left empty.
+ - What it does: Returns the tensor's storage to the pool. Works for any tensor, not only acquired ones.
+ - Return Value: None.
+ */
+void UNeuralNetworkModel::ReleaseTensor(UPARAM(ref) FNeuralNetworkTensor& Tensor)
+{
+    GetTensorPool()->ReleaseArray(Tensor.Data);
+    Tensor.Shape.Reset();
+}
+
+void UNeuralNetworkModel::ConfigureTensorPool(const FNeuralNetworkTensorPoolSettings& Settings)
+{
+    TensorPool = FNeuralNetworkTensorPool::Create(Settings);
+}
+
+void UNeuralNetworkModel::TrimTensorPool()
+{
+    if (TensorPool.IsValid())
+    {
+        TensorPool->Trim();
+    }
+}
+
+/*
+ - Parameters: None.
+ - What it does: Reports pool hits and misses and the memory held, use HighWaterBytes to pick MaxPooledMegabytes.
+ - Return Value: FNeuralNetworkTensorPoolStats, all zero before the pool was first used.
+ */
+FNeuralNetworkTensorPoolStats UNeuralNetworkModel::GetTensorPoolStats() const
+{
+    return TensorPool.IsValid() ? TensorPool->GetStats() : FNeuralNetworkTensorPoolStats();
+}
+
+TSharedPtr<FNeuralNetworkTensorPool, ESPMode::ThreadSafe> UNeuralNetworkModel::GetTensorPool()
+{
+    if (!TensorPool.IsValid())
+    {
+        TensorPool = FNeuralNetworkTensorPool::Create(FNeuralNetworkTensorPoolSettings());
+    }
+    return TensorPool;
+}
+
+// ######################################################################################################################
+
+/*
+ - Parameters:
+    1) Shape: The shape of the tensor.
+ - What it does: Allocates an uninitialized tensor from the tensor pool and registers it. The data never leaves native
+   memory, Blueprint only holds the handle.
+ - Return Value: FNeuralNetworkTensorHandle, invalid if the shape is invalid.
+ */
+FNeuralNetworkTensorHandle UNeuralNetworkModel::CreateTensorHandle(TArray<int32> Shape)
+{
+    int64 Volume = Shape.Num() > 0 ? 1 : 0;
+    for (int32 Dim : Shape)
+    {
+        Volume *= FMath::Max(Dim, 0);
+    }
+    if (Volume < 1 || Volume > MAX_int32)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("CreateTensorHandle failed: Invalid shape %s"), *FString::JoinBy(Shape, TEXT(", "), [](int32 Val) { return FString::FromInt(Val); }));
+        return FNeuralNetworkTensorHandle();
+    }
+
+    TUniquePtr<FNeuralNetworkTensorStorage> Storage = MakeUnique<FNeuralNetworkTensorStorage>();
+    Storage->Buffer = GetTensorPool()->Acquire(static_cast<int32>(Volume));
+    if (!Storage->Buffer.IsValid())
+    {
+        return FNeuralNetworkTensorHandle();
+    }
+    Storage->Shape = MoveTemp(Shape);
+
+    return FNeuralNetworkTensorRegistry::Get().Add(MoveTemp(Storage));
+}
+
+void UNeuralNetworkModel::ReleaseTensorHandle(UPARAM(ref) FNeuralNetworkTensorHandle& Handle)
+{
+    FNeuralNetworkTensorRegistry::Get().Release(Handle);
+    Handle = FNeuralNetworkTensorHandle();
+}
+
+void UNeuralNetworkModel::ReleaseImageHandle(UPARAM(ref) FNeuralNetworkImageHandle& Handle)
+{
+    FNeuralNetworkTensorRegistry::Get().Release(Handle);
+    Handle = FNeuralNetworkImageHandle();
+}
+
+TArray<int32> UNeuralNetworkModel::GetTensorHandleShape(const FNeuralNetworkTensorHandle& Handle)
+{
+    const FNeuralNetworkTensorStorage* Storage = FNeuralNetworkTensorRegistry::Get().Find(Handle);
+    return Storage ? Storage->Shape : TArray<int32>();
+}
+
+/*
+ - Parameters:
+    1) Handle: The tensor to read.
+    2) Tensor: Receives a copy of its shape and data.
+ - What it does: Copies the tensor into Blueprint memory, meant for debugging and tests rather than the frame loop.
+ - Return Value: bool indicating whether the handle was valid.
+ */
+bool UNeuralNetworkModel::CopyTensorHandle(const FNeuralNetworkTensorHandle& Handle, FNeuralNetworkTensor& Tensor)
+{
+    const FNeuralNetworkTensorStorage* Storage = FNeuralNetworkTensorRegistry::Get().Find(Handle);
+    if (!Storage)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("CopyTensorHandle failed: Invalid handle %lld"), Handle.Id);
+        return false;
+    }
+
+    Tensor.Shape = Storage->Shape;
+    Tensor.Data.Reset();
+    Tensor.Data.Append(Storage->Buffer.GetData(), Storage->Buffer.Num());
+    return true;
+}
+
+/*
+ - Parameters:
+    1) FilePath: Absolute path of a PNG file.
+ - What it does: Decodes the PNG straight into a registered image, the pixels are never returned to Blueprint.
+ - Return Value: FNeuralNetworkImageHandle, invalid if the file could not be decoded.
+ */
+FNeuralNetworkImageHandle UNeuralNetworkModel::LoadPNGToImageHandle(const FString& FilePath)
+{
+    TUniquePtr<FNeuralNetworkImageStorage> Storage = MakeUnique<FNeuralNetworkImageStorage>();
+    Storage->Pixels = LoadPNGToPixelArray(FilePath, Storage->Width, Storage->Height);
+    Storage->Format = ENeuralNetworkPixelFormat::RGBA8;
+    if (Storage->Pixels.Num() == 0)
+    {
+        return FNeuralNetworkImageHandle();
+    }
+
+    return FNeuralNetworkTensorRegistry::Get().Add(MoveTemp(Storage));
+}
+
+FNeuralNetworkImageHandle UNeuralNetworkModel::ProcessScreenshotHandle()
+{
+    return LoadPNGToImageHandle(GetScreenshotPath());
+}
+
+/*
+ - Parameters:
+    1) RenderTarget: The render target to read, e.g. the target of a USceneCaptureComponent2D.
+ - What it does: Reads the render target back into a registered image. Game thread only, like PreprocessRenderTarget.
+ - Return Value: FNeuralNetworkImageHandle, invalid if the readback failed.
+ */
+FNeuralNetworkImageHandle UNeuralNetworkModel::ReadRenderTargetHandle(UTextureRenderTarget2D* RenderTarget)
+{
+    check(IsInGameThread());
+
+    FTextureRenderTargetResource* RenderTargetResource = RenderTarget ? RenderTarget->GameThread_GetRenderTargetResource() : nullptr;
+    if (!RenderTargetResource)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("ReadRenderTargetHandle failed: No render target resource"));
+        return FNeuralNetworkImageHandle();
+    }
+
+    TUniquePtr<FNeuralNetworkImageStorage> Storage = MakeUnique<FNeuralNetworkImageStorage>();
+    if (!RenderTargetResource->ReadPixels(Storage->Colors) || Storage->Colors.Num() < RenderTarget->SizeX * RenderTarget->SizeY)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("ReadRenderTargetHandle failed: Failed to read pixel data!"));
+        return FNeuralNetworkImageHandle();
+    }
+    Storage->Width = RenderTarget->SizeX;
+    Storage->Height = RenderTarget->SizeY;
+    Storage->Format = ENeuralNetworkPixelFormat::BGRA8;
+
+    return FNeuralNetworkTensorRegistry::Get().Add(MoveTemp(Storage));
+}
+
+/*
+ - Parameters:
+    1) Image: The image to preprocess.
+    2) Tensor: The input tensor to fill. Its shape is kept if it is 1x3xHxW, otherwise it is set to the model's image
+       input shape. An invalid handle is replaced by a new one, release it like any other handle.
+    3) Letterbox: Receives the mapping back to the image.
+ - What it does: PreprocessImage from one handle into the other, reading and writing the native memory in place.
+ - Return Value: bool indicating whether the tensor was filled.
+ */
+bool UNeuralNetworkModel::PreprocessImageHandle(const FNeuralNetworkImageHandle& Image, UPARAM(ref) FNeuralNetworkTensorHandle& Tensor, FNeuralNetworkLetterbox& Letterbox)
+{
+    FNeuralNetworkTensorRegistry& Registry = FNeuralNetworkTensorRegistry::Get();
+
+    const FNeuralNetworkImageStorage* ImageStorage = Registry.Find(Image);
+    if (!ImageStorage || !ModelInstance.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("PreprocessImageHandle failed: Invalid image handle %lld or model instance"), Image.Id);
+        return false;
+    }
+
+    FNeuralNetworkTensorStorage* TensorStorage = Registry.Find(Tensor);
+    if (!TensorStorage)
+    {
+        Tensor = Registry.Add(MakeUnique<FNeuralNetworkTensorStorage>());
+        TensorStorage = Registry.Find(Tensor);
+    }
+
+    const TArray<int32>& Shape = TensorStorage->Shape;
+    if (!(Shape.Num() == 4 && Shape[0] == 1 && Shape[1] == 3 && Shape[2] > 0 && Shape[3] > 0))
+    {
+        TensorStorage->Shape = GetImageInputShape();
+    }
+
+    const int32 TargetHeight = TensorStorage->Shape[2];
+    const int32 TargetWidth = TensorStorage->Shape[3];
+    if (!GetTensorPool()->Resize(TensorStorage->Buffer, 3 * TargetWidth * TargetHeight))
+    {
+        return false;
+    }
+
+    return NeuralNetworkPreprocess::Letterbox(ImageStorage->GetView(), TargetWidth, TargetHeight, TensorStorage->Buffer.GetData(), Letterbox);
+}
+
+/*
+ - Parameters:
+    1) Inputs: One tensor handle per model input.
+ - What it does: Binds the handles' native memory as the model inputs, nothing is copied. The tensors must not be
+   released before the last RunSyncHandles using them.
+ - Return Value: bool indicating whether every input was bound.
+ */
+bool UNeuralNetworkModel::SetInputHandles(const TArray<FNeuralNetworkTensorHandle>& Inputs)
+{
+    FNeuralNetworkTensorRegistry& Registry = FNeuralNetworkTensorRegistry::Get();
+
+    for (int32 i = 0; i < Inputs.Num(); i++)
+    {
+        const FNeuralNetworkTensorStorage* Storage = Registry.Find(Inputs[i]);
+        if (!Storage)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("SetInputHandles failed: Input %d has an invalid handle"), i);
+            return false;
+        }
+        if (!BindInput(i, Storage->Buffer.GetData(), Storage->Buffer.Num(), Storage->Shape))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Outputs: Output handles, reused when they already hold the right size. Missing or invalid entries are replaced
+       by new handles.
+ - What it does: Sizes the outputs for the bound inputs, binds their native memory and runs the model into it.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::RunSyncHandles(UPARAM(ref) TArray<FNeuralNetworkTensorHandle>& Outputs)
+{
+    if (!ModelInstance.IsValid() || bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunSyncHandles failed: Model instance is invalid or a RunAsync call is in flight"));
+        return false;
+    }
+
+    // Resolve the output shapes for the bound inputs before sizing the outputs
+    if (!ApplyInputShapes(BoundInputShapes))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunSyncHandles failed: Could not set input tensor shapes"));
+        return false;
+    }
+
+    FNeuralNetworkTensorRegistry& Registry = FNeuralNetworkTensorRegistry::Get();
+    const TSharedPtr<FNeuralNetworkTensorPool, ESPMode::ThreadSafe> Pool = GetTensorPool();
+
+    const int32 NumOutputs = ModelInstance->GetOutputTensorDescs().Num();
+    Outputs.SetNum(NumOutputs);
+    for (int32 i = 0; i < NumOutputs; i++)
+    {
+        FNeuralNetworkTensorStorage* Storage = Registry.Find(Outputs[i]);
+        if (!Storage)
+        {
+            Outputs[i] = Registry.Add(MakeUnique<FNeuralNetworkTensorStorage>());
+            Storage = Registry.Find(Outputs[i]);
+        }
+
+        Storage->Shape = GetOutputShape(i);
+        int32 Volume = 1;
+        for (int32 Dim : Storage->Shape)
+        {
+            Volume *= Dim;
+        }
+
+        if (!Pool->Resize(Storage->Buffer, Volume) || !BindOutput(i, Storage->Buffer.GetData(), Volume))
+        {
+            return false;
+        }
+    }
+
+    return RunPrepared();
+}
+
+bool UNeuralNetworkModel::DecodeDetectionsHandle(const FNeuralNetworkTensorHandle& Output, const FNeuralNetworkLetterbox& Letterbox, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    const FNeuralNetworkTensorStorage* Storage = FNeuralNetworkTensorRegistry::Get().Find(Output);
+    if (!Storage)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DecodeDetectionsHandle failed: Invalid handle %lld"), Output.Id);
+        return false;
+    }
+
+    return DecodeOutput(Storage->Shape, Storage->GetView(), Letterbox, Settings, Detections);
+}
+
+/*
+ - Parameters:
+    1) Image: The frame to run.
+    2) Settings, Detections: Same as Detect.
+ - What it does: Detect on a registered image, the pixels go from the handle's memory straight into preprocessing.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::DetectImageHandle(const FNeuralNetworkImageHandle& Image, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    const FNeuralNetworkImageStorage* Storage = FNeuralNetworkTensorRegistry::Get().Find(Image);
+    if (!Storage)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectImageHandle failed: Invalid handle %lld"), Image.Id);
+        return false;
+    }
+
+    return DetectImage(Storage->GetView(), Settings, Detections);
+}
+
+/*
+ - Parameters:
+    1) Inputs: An array of FNeuralNetworkTensor containing the input tensors.
+ - What it does: Assigns the input tensors to the model and sets their shapes for inference.
+ - Return Value: bool indicating whether the inputs were successfully set.
+ */
+bool UNeuralNetworkModel::SetInputs(const TArray<FNeuralNetworkTensor>& Inputs)
+{
+    NEURAL_NETWORK_SCOPE(Bind);
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("SetInputs called"));
+    if (!Model.IsValid() || !ModelInstance.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("SetInputs failed: Model instance is invalid, the model may still be loading"));
+        return false;
+    }
+
+    if (bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("SetInputs failed: A RunAsync call is still in flight"));
+        return false;
+    }
+
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("SetInputs called with %d input tensors"), Inputs.Num());
+
+    using namespace UE::NNE;
+
+    TConstArrayView<FTensorDesc> InputDescs = ModelInstance->GetInputTensorDescs();
+    if (InputDescs.Num() != Inputs.Num())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("SetInputs failed: Expected %d input tensors, but got %d"), InputDescs.Num(), Inputs.Num());
+        return false;
+    }
+
+    for (int32 i = 0; i < Inputs.Num(); i++)
+    {
+        // Tensors without a shape get the fixed YOLOv8 shape (1x3x640x640)
+        const TArray<int32>& Shape = Inputs[i].Shape.Num() > 0 ? Inputs[i].Shape : FIXED_INPUT_SHAPE;
+
+        // Directly bind the input data, assuming it is already in the correct shape
+        if (!BindInput(i, Inputs[i].Data.GetData(), Inputs[i].Data.Num(), Shape))
+        {
+            return false;
+        }
+
+        UE_LOG(LogNeuralNetwork, Verbose, TEXT("SetInputs: Tensor %d -> Shape: %s, Size: %d bytes"),
+            i,
+            *FString::JoinBy(Shape, TEXT(", "), [](int32 Val) { return FString::FromInt(Val); }),
+            InputBindings[i].SizeInBytes);
+    }
+
+    // Only re-plans the model instance when the shapes differ from the previous call
+    if (!ApplyInputShapes(BoundInputShapes))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("SetInputs failed: Could not set input tensor shapes"));
+        return false;
+    }
+
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("SetInputs: Successfully set input tensors."));
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Outputs: A reference to an array of FNeuralNetworkTensor to store the model's output.
+ - What it does: Runs the model synchronously using the provided inputs and populates the output tensors.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::RunSync(UPARAM(ref) TArray<FNeuralNetworkTensor>& Outputs)
+{
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("RunSync called"));
+
+    if (!Model.IsValid() || !ModelInstance.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunSync failed: Model instance is invalid!"));
+        return false;
+    }
+
+    if (bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunSync failed: A RunAsync call is still in flight"));
+        return false;
+    }
+
+    using namespace UE::NNE;
+
+    // Batched and Detect runs leave the instance prepared for their own shapes, switch back to the bound inputs
+    if (!ApplyInputShapes(BoundInputShapes))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunSync failed: Could not set input tensor shapes"));
+        return false;
+    }
+
+    TConstArrayView<FTensorDesc> OutputDescs = ModelInstance->GetOutputTensorDescs();
+    if (OutputDescs.Num() != Outputs.Num())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunSync failed: Expected %d output tensors, but got %d"), OutputDescs.Num(), Outputs.Num());
+        return false;
+    }
+
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("RunSync: Preparing output bindings..."));
+
+    OutputBindings.SetNum(Outputs.Num(), false);
+
+    for (int32 i = 0; i < Outputs.Num(); i++)
+    {
+        if (Outputs[i].Data.Num() == 0)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RunSync failed: Output tensor at index %d is empty"), i);
+            return false;
+        }
+
+        OutputBindings[i].Data = (void*)Outputs[i].Data.GetData();
+        OutputBindings[i].SizeInBytes = Outputs[i].Data.Num() * sizeof(float);
+
+        UE_LOG(LogNeuralNetwork, Verbose, TEXT("RunSync: Output Tensor %d -> Size: %d bytes"), i, OutputBindings[i].SizeInBytes);
+    }
+
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("RunSync: Running model synchronously..."));
+
+    {
+        NEURAL_NETWORK_SCOPE(Run);
+
+        EResultStatus RunStatus = ModelInstance->RunSync(InputBindings, OutputBindings);
+        if (RunStatus != UE::NNE::EResultStatus::Ok)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RunSync failed: Model execution returned an error"));
+            return false;
+        }
+    }
+    INC_DWORD_STAT(STAT_NeuralNetwork_Inferences);
+
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("RunSync: Model execution successful!"));
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Inputs: Input tensors that stay alive and in place for as long as the session is used.
+    2) Outputs: Output tensors sized for the model's outputs, also kept alive and in place.
+ - What it does: Binds the input and output memory once and prepares the model instance for the input shapes.
+   Afterwards write new frame data into the same arrays and call RunPrepared.
+ - Return Value: bool indicating whether the session was prepared.
+ */
+bool UNeuralNetworkModel::PrepareSession(const TArray<FNeuralNetworkTensor>& Inputs, UPARAM(ref) TArray<FNeuralNetworkTensor>& Outputs)
+{
+    if (!SetInputs(Inputs))
+    {
+        return false;
+    }
+
+    if (ModelInstance->GetOutputTensorDescs().Num() != Outputs.Num())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("PrepareSession failed: Expected %d output tensors, but got %d"), ModelInstance->GetOutputTensorDescs().Num(), Outputs.Num());
+        return false;
+    }
+
+    for (int32 i = 0; i < Outputs.Num(); i++)
+    {
+        if (!BindOutput(i, Outputs[i].Data.GetData(), Outputs[i].Data.Num()))
+        {
+            return false;
+        }
+    }
+
+    UE_LOG(LogNeuralNetwork, Log, TEXT("PrepareSession: Bound %d inputs and %d outputs"), Inputs.Num(), Outputs.Num());
+    return true;
+}
+
+/*
+ - Parameters: None.
+ - What it does: Runs the model on the buffers bound by PrepareSession / BindInput / BindOutput. The instance is only
+   re-planned if a bound input shape changed. Nothing is allocated or logged unless an error occurs.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::RunPrepared()
+{
+    NEURAL_NETWORK_SCOPE(Run);
+
+    using namespace UE::NNE;
+
+    if (!ModelInstance.IsValid() || bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunPrepared failed: Model instance is invalid or a RunAsync call is in flight"));
+        return false;
+    }
+
+    const int32 NumInputs = ModelInstance->GetInputTensorDescs().Num();
+    const int32 NumOutputs = ModelInstance->GetOutputTensorDescs().Num();
+    if (InputBindings.Num() != NumInputs || OutputBindings.Num() != NumOutputs)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunPrepared failed: The session has not been prepared"));
+        return false;
+    }
+
+    for (const FTensorBindingCPU& Binding : InputBindings)
+    {
+        if (!Binding.Data)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RunPrepared failed: An input is not bound"));
+            return false;
+        }
+    }
+    for (const FTensorBindingCPU& Binding : OutputBindings)
+    {
+        if (!Binding.Data)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RunPrepared failed: An output is not bound"));
+            return false;
+        }
+    }
+
+    if (!ApplyInputShapes(BoundInputShapes))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunPrepared failed: Could not set input tensor shapes"));
+        return false;
+    }
+
+    if (ModelInstance->RunSync(InputBindings, OutputBindings) != EResultStatus::Ok)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunPrepared failed: Model execution returned an error"));
+        return false;
+    }
+
+    INC_DWORD_STAT(STAT_NeuralNetwork_Inferences);
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Index: The model input to bind.
+    2) Data, NumElements: Caller owned float memory that must outlive the session.
+    3) Shape: Concrete shape of the input.
+ - What it does: Points one input binding at the memory and records its shape. The binding arrays only grow, so
+   rebinding the same number of inputs never allocates.
+ - Return Value: bool indicating whether the input was bound.
+ */
+bool UNeuralNetworkModel::BindInput(int32 Index, const float* Data, int32 NumElements, TConstArrayView<int32> Shape)
+{
+    using namespace UE::NNE;
+
+    const int32 NumInputs = ModelInstance.IsValid() ? ModelInstance->GetInputTensorDescs().Num() : 0;
+    if (Index < 0 || Index >= NumInputs || !Data || NumElements < 1)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("BindInput failed: Invalid input %d (model has %d inputs)"), Index, NumInputs);
+        return false;
+    }
+
+    if (bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("BindInput failed: A RunAsync call is still in flight"));
+        return false;
+    }
+
+    InputBindings.SetNum(NumInputs, false);
+    BoundInputShapes.SetNum(NumInputs, false);
+
+    InputBindings[Index].Data = (void*)Data;
+    InputBindings[Index].SizeInBytes = NumElements * sizeof(float);
+    BoundInputShapes[Index] = FTensorShape::MakeFromSymbolic(FSymbolicTensorShape::Make(Shape));
+
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Index: The model output to bind.
+    2) Data, NumElements: Caller owned float memory that must outlive the session.
+ - What it does: Points one output binding at the memory used by RunPrepared.
+ - Return Value: bool indicating whether the output was bound.
+ */
+bool UNeuralNetworkModel::BindOutput(int32 Index, float* Data, int32 NumElements)
+{
+    const int32 NumOutputs = ModelInstance.IsValid() ? ModelInstance->GetOutputTensorDescs().Num() : 0;
+    if (Index < 0 || Index >= NumOutputs || !Data || NumElements < 1)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("BindOutput failed: Invalid output %d (model has %d outputs)"), Index, NumOutputs);
+        return false;
+    }
+
+    if (bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("BindOutput failed: A RunAsync call is still in flight"));
+        return false;
+    }
+
+    OutputBindings.SetNum(NumOutputs, false);
+    OutputBindings[Index].Data = Data;
+    OutputBindings[Index].SizeInBytes = NumElements * sizeof(float);
+
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Shapes: Concrete input shapes.
+ - What it does: Makes ModelInstance an instance prepared for the shapes. Nothing happens if it already is. Otherwise an
+   instance prepared earlier for the same shapes is swapped in from the shape cache, and only on a cache miss is
+   SetInputTensorShapes called (shape inference and reallocation inside the runtime). The instance being replaced is
+   parked in the cache, evicting the least recently used entry when full.
+ - Return Value: bool indicating whether the instance is prepared for the shapes.
+ */
+bool UNeuralNetworkModel::ApplyInputShapes(TConstArrayView<UE::NNE::FTensorShape> Shapes)
+{
+    using namespace UE::NNE;
+
+    auto ShapesEqual = [](TConstArrayView<FTensorShape> A, TConstArrayView<FTensorShape> B)
+    {
+        if (A.Num() != B.Num())
+        {
+            return false;
+        }
+        for (int32 i = 0; i < A.Num(); i++)
+        {
+            if (A[i] != B[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if (ShapesEqual(InputShapes, Shapes))
+    {
+        return true;
+    }
+
+    for (FNeuralNetworkPreparedInstance& Entry : PreparedInstances)
+    {
+        if (ShapesEqual(Entry.Shapes, Shapes))
+        {
+            Swap(ModelInstance, Entry.Instance);
+            Swap(InputShapes, Entry.Shapes);
+            Entry.LastUsed = ++PreparedInstanceUseCount;
+            if (Entry.Shapes.Num() == 0)
+            {
+                // The instance swapped out was never prepared, nothing worth keeping
+                PreparedInstances.RemoveAllSwap([](const FNeuralNetworkPreparedInstance& Unprepared) { return Unprepared.Shapes.Num() == 0; });
+            }
+            UE_LOG(LogNeuralNetwork, Verbose, TEXT("ApplyInputShapes: Reused the instance prepared for this input shape"));
+            return true;
+        }
+    }
+
+    // Keep the current plan if there is one and the cache is enabled, prepare a different instance instead
+    const bool bParkCurrent = MaxPreparedInstances > 0 && InputShapes.Num() > 0;
+    TSharedPtr<IModelInstanceCPU> Target = ModelInstance;
+    int32 EvictIndex = INDEX_NONE;
+    if (bParkCurrent)
+    {
+        if (PreparedInstances.Num() < MaxPreparedInstances)
+        {
+            Target = Model->CreateModelInstanceCPU();
+        }
+        else
+        {
+            EvictIndex = 0;
+            for (int32 i = 1; i < PreparedInstances.Num(); i++)
+            {
+                if (PreparedInstances[i].LastUsed < PreparedInstances[EvictIndex].LastUsed)
+                {
+                    EvictIndex = i;
+                }
+            }
+            Target = PreparedInstances[EvictIndex].Instance;
+        }
+    }
+
+    if (!Target.IsValid() || Target->SetInputTensorShapes(Shapes) != EResultStatus::Ok)
+    {
+        if (Target == ModelInstance)
+        {
+            InputShapes.Reset();
+        }
+        else if (EvictIndex != INDEX_NONE)
+        {
+            PreparedInstances.RemoveAtSwap(EvictIndex);
+        }
+        return false;
+    }
+
+    if (bParkCurrent)
+    {
+        FNeuralNetworkPreparedInstance Parked;
+        Parked.Instance = ModelInstance;
+        Parked.Shapes = MoveTemp(InputShapes);
+        Parked.LastUsed = ++PreparedInstanceUseCount;
+
+        if (EvictIndex != INDEX_NONE)
+        {
+            PreparedInstances[EvictIndex] = MoveTemp(Parked);
+        }
+        else
+        {
+            PreparedInstances.Add(MoveTemp(Parked));
+        }
+        ModelInstance = Target;
+    }
+
+    InputShapes.Reset();
+    InputShapes.Append(Shapes.GetData(), Shapes.Num());
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Outputs: Output tensors with the shapes and sizes the model produces, only their sizes are used.
+ - What it does: Copies the inputs bound by SetInputs into storage owned by this object and runs the model on a worker
+   task. OnRunCompleted is broadcast on the game thread with the results. SetInputs, RunSync and RunAsync are refused
+   until then.
+ - Return Value: bool indicating whether the run was started.
+ */
+bool UNeuralNetworkModel::RunAsync(const TArray<FNeuralNetworkTensor>& Outputs)
+{
+    check(IsInGameThread());
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("RunAsync called"));
+
+    if (!Model.IsValid() || !ModelInstance.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunAsync failed: Model instance is invalid!"));
+        return false;
+    }
+
+    if (bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunAsync failed: A previous RunAsync call is still in flight"));
+        return false;
+    }
+
+    using namespace UE::NNE;
+
+    if (InputBindings.Num() != ModelInstance->GetInputTensorDescs().Num())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunAsync failed: SetInputs has not been called"));
+        return false;
+    }
+
+    if (ModelInstance->GetOutputTensorDescs().Num() != Outputs.Num())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunAsync failed: Expected %d output tensors, but got %d"), ModelInstance->GetOutputTensorDescs().Num(), Outputs.Num());
+        return false;
+    }
+
+    // A batched or Detect call in between may have left the instance prepared for another shape
+    if (!ApplyInputShapes(BoundInputShapes))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunAsync failed: Could not set input tensor shapes"));
+        return false;
+    }
+
+    if (!AsyncRun.IsValid())
+    {
+        AsyncRun = MakeShared<FNeuralNetworkAsyncRun, ESPMode::ThreadSafe>();
+    }
+    FNeuralNetworkAsyncRun& Run = *AsyncRun;
+
+    // Snapshot the caller owned input memory, the allocations are kept for the next run
+    Run.InputData.SetNum(InputBindings.Num());
+    Run.InputBindings.SetNum(InputBindings.Num());
+    for (int32 i = 0; i < InputBindings.Num(); i++)
+    {
+        const int32 NumFloats = static_cast<int32>(InputBindings[i].SizeInBytes / sizeof(float));
+        Run.InputData[i].SetNumUninitialized(NumFloats);
+        FMemory::Memcpy(Run.InputData[i].GetData(), InputBindings[i].Data, InputBindings[i].SizeInBytes);
+
+        Run.InputBindings[i].Data = Run.InputData[i].GetData();
+        Run.InputBindings[i].SizeInBytes = InputBindings[i].SizeInBytes;
+    }
+
+    Run.Outputs.SetNum(Outputs.Num());
+    Run.OutputBindings.SetNum(Outputs.Num());
+    for (int32 i = 0; i < Outputs.Num(); i++)
+    {
+        if (Outputs[i].Data.Num() == 0)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RunAsync failed: Output tensor at index %d is empty"), i);
+            return false;
+        }
+
+        Run.Outputs[i].Shape = Outputs[i].Shape;
+        Run.Outputs[i].Data.SetNumUninitialized(Outputs[i].Data.Num());
+
+        Run.OutputBindings[i].Data = Run.Outputs[i].Data.GetData();
+        Run.OutputBindings[i].SizeInBytes = Run.Outputs[i].Data.Num() * sizeof(float);
+    }
+
+    Run.bCancelled = false;
+    Run.bWorkerActive = true;
+    bRunInFlight = true;
+
+    TWeakObjectPtr<UNeuralNetworkModel> WeakThis(this);
+    TSharedPtr<FNeuralNetworkAsyncRun, ESPMode::ThreadSafe> RunState = AsyncRun;
+    TSharedPtr<IModelInstanceCPU> Instance = ModelInstance;
+
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, RunState, Instance]()
+    {
+        bool bSuccess = false;
+        if (!RunState->bCancelled)
+        {
+            NEURAL_NETWORK_SCOPE(Run);
+            bSuccess = Instance->RunSync(RunState->InputBindings, RunState->OutputBindings) == EResultStatus::Ok;
+            INC_DWORD_STAT(STAT_NeuralNetwork_Inferences);
+        }
+        RunState->bWorkerActive = false;
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, RunState, bSuccess]()
+        {
+            UNeuralNetworkModel* This = WeakThis.Get();
+            if (!This || RunState->bCancelled)
+            {
+                return;
+            }
+
+            This->bRunInFlight = false;
+            if (!bSuccess)
+            {
+                UE_LOG(LogNeuralNetwork, Error, TEXT("RunAsync failed: Model execution returned an error"));
+            }
+            This->OnRunCompleted.Broadcast(bSuccess, RunState->Outputs);
+        });
+    });
+
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Frames: Preprocessed frames, each 1x3xHxW (or 3xHxW) and all with the same shape.
+    2) FrameOutputs: Receives NumOutputs() tensors per frame, frame major, with a batch dimension of 1.
+ - What it does: Packs the frames into one contiguous Nx3xHxW input and runs them through the model in a single call.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::RunBatch(const TArray<FNeuralNetworkTensor>& Frames, UPARAM(ref) TArray<FNeuralNetworkTensor>& FrameOutputs)
+{
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("RunBatch called with %d frames"), Frames.Num());
+
+    if (Frames.Num() == 0)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunBatch failed: No frames"));
+        return false;
+    }
+
+    // A leading batch dimension of 1 is dropped, the frame shape is what remains
+    TArray<int32> FrameShape = Frames[0].Shape.Num() > 0 ? Frames[0].Shape : FIXED_INPUT_SHAPE;
+    if (FrameShape.Num() == 4 && FrameShape[0] == 1)
+    {
+        FrameShape.RemoveAt(0);
+    }
+
+    const int32 FrameVolume = Frames[0].Data.Num();
+    for (int32 i = 0; i < Frames.Num(); i++)
+    {
+        if (Frames[i].Data.Num() != FrameVolume || FrameVolume == 0)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RunBatch failed: Frame %d has %d elements, expected %d"), i, Frames[i].Data.Num(), FrameVolume);
+            return false;
+        }
+    }
+
+    {
+        NEURAL_NETWORK_SCOPE(Bind);
+
+        if (!GetTensorPool()->Resize(BatchInput, Frames.Num() * FrameVolume))
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RunBatch failed: Could not allocate the batch input"));
+            return false;
+        }
+        for (int32 i = 0; i < Frames.Num(); i++)
+        {
+            FMemory::Memcpy(BatchInput.GetData() + i * FrameVolume, Frames[i].Data.GetData(), FrameVolume * sizeof(float));
+        }
+    }
+
+    TArray<int32, TInlineAllocator<4>> BatchShape;
+    BatchShape.Add(Frames.Num());
+    BatchShape.Append(FrameShape);
+
+    return RunBatched(BatchInput, BatchShape, FrameOutputs);
+}
+
+/*
+ - Parameters:
+    1) PackedInput: Contiguous input data for the whole batch, only read during the call.
+    2) BatchShape: Concrete shape of the batch, the first dimension is the number of frames.
+    3) FrameOutputs: Receives NumOutputs() tensors per frame, frame major, with a batch dimension of 1.
+ - What it does: Sets the dynamic batch size on the model instance, runs it once and splits every output along its
+   first dimension into per frame tensors. The input is bound for this call only, the PrepareSession bindings and
+   shapes stay as they were and the next RunPrepared / RunAsync switches the instance back to them.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::RunBatched(TConstArrayView<float> PackedInput, TConstArrayView<int32> BatchShape, TArray<FNeuralNetworkTensor>& FrameOutputs)
+{
+    using namespace UE::NNE;
+
+    if (!Model.IsValid() || !ModelInstance.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunBatched failed: Model instance is invalid!"));
+        return false;
+    }
+
+    if (bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunBatched failed: A RunAsync call is still in flight"));
+        return false;
+    }
+
+    if (ModelInstance->GetInputTensorDescs().Num() != 1)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunBatched failed: Batching needs a model with a single input, this one has %d"), ModelInstance->GetInputTensorDescs().Num());
+        return false;
+    }
+
+    TArray<uint32, TInlineAllocator<4>> ConcreteShape;
+    int64 Volume = 1;
+    for (int32 Dim : BatchShape)
+    {
+        if (Dim < 1)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RunBatched failed: Invalid batch shape dimension %d"), Dim);
+            return false;
+        }
+        ConcreteShape.Add(static_cast<uint32>(Dim));
+        Volume *= Dim;
+    }
+
+    if (ConcreteShape.Num() == 0 || Volume != PackedInput.Num())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunBatched failed: Batch input has %d elements, the shape needs %lld"), PackedInput.Num(), Volume);
+        return false;
+    }
+
+    const int32 NumFrames = BatchShape[0];
+
+    const FTensorShape BatchTensorShape = FTensorShape::Make(ConcreteShape);
+    if (!ApplyInputShapes(MakeArrayView(&BatchTensorShape, 1)))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunBatched failed: Could not set batch size %d, the model may not have a dynamic batch dimension"), NumFrames);
+        return false;
+    }
+
+    FTensorBindingCPU BatchInputBinding;
+    BatchInputBinding.Data = (void*)PackedInput.GetData();
+    BatchInputBinding.SizeInBytes = PackedInput.Num() * sizeof(float);
+
+    // Output shapes are concrete once the input shapes are set
+    TConstArrayView<FTensorShape> OutputShapes = ModelInstance->GetOutputTensorShapes();
+    const int32 NumOutputs = OutputShapes.Num();
+
+    const TSharedPtr<FNeuralNetworkTensorPool, ESPMode::ThreadSafe> Pool = GetTensorPool();
+    BatchOutputs.SetNum(NumOutputs);
+    TArray<FTensorBindingCPU, TInlineAllocator<4>> BatchOutputBindings;
+    BatchOutputBindings.SetNum(NumOutputs);
+    for (int32 o = 0; o < NumOutputs; o++)
+    {
+        if (OutputShapes[o].Rank() == 0 || OutputShapes[o].GetData()[0] != static_cast<uint32>(NumFrames))
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RunBatched failed: Output %d is not batched along its first dimension"), o);
+            return false;
+        }
+
+        if (!Pool->Resize(BatchOutputs[o], static_cast<int32>(OutputShapes[o].Volume())))
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RunBatched failed: Could not allocate output %d"), o);
+            return false;
+        }
+        BatchOutputBindings[o].Data = BatchOutputs[o].GetData();
+        BatchOutputBindings[o].SizeInBytes = BatchOutputs[o].Num() * sizeof(float);
+    }
+
+    {
+        NEURAL_NETWORK_SCOPE(Run);
+
+        if (ModelInstance->RunSync(MakeArrayView(&BatchInputBinding, 1), BatchOutputBindings) != EResultStatus::Ok)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RunBatched failed: Model execution returned an error"));
+            return false;
+        }
+    }
+    INC_DWORD_STAT_BY(STAT_NeuralNetwork_Inferences, NumFrames);
+
+    FrameOutputs.SetNum(NumFrames * NumOutputs);
+    for (int32 o = 0; o < NumOutputs; o++)
+    {
+        const int32 FrameVolume = BatchOutputs[o].Num() / NumFrames;
+
+        TArray<int32> FrameShape;
+        for (uint32 Dim : OutputShapes[o].GetData())
+        {
+            FrameShape.Add(static_cast<int32>(Dim));
+        }
+        FrameShape[0] = 1;
+
+        for (int32 f = 0; f < NumFrames; f++)
+        {
+            FNeuralNetworkTensor& Output = FrameOutputs[f * NumOutputs + o];
+            Output.Shape = FrameShape;
+            Output.Data.SetNumUninitialized(FrameVolume);
+            FMemory::Memcpy(Output.Data.GetData(), BatchOutputs[o].GetData() + f * FrameVolume, FrameVolume * sizeof(float));
+        }
+    }
+
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("RunBatched: Ran %d frames in one call"), NumFrames);
+    return true;
+}
+
+/*
+ - Parameters:
+    1) PoolSize: Number of model instances that can run at the same time.
+ - What it does: Creates a pool of instances that share this object's model weights. Must be called before RunPooled.
+ - Return Value: bool indicating whether the pool was created.
+ */
+bool UNeuralNetworkModel::CreateInstancePool(int32 PoolSize)
+{
+    check(IsInGameThread());
+
+    if (!Model.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("CreateInstancePool failed: Model is invalid!"));
+        return false;
+    }
+
+    InstancePool = FNeuralNetworkInstancePool::Create(Model, PoolSize);
+    return InstancePool.IsValid();
+}
+
+/*
+ - Parameters:
+    1) Inputs: The input tensors, their Shape arrays are used as the concrete input shapes.
+    2) Outputs: Output tensors sized for the model's outputs.
+    3) WaitMilliseconds: How long to wait for a free instance, 0 fails immediately when all are busy.
+ - What it does: Runs the model on an instance checked out of the pool. Does not touch the state used by
+   SetInputs / RunSync, so it can be called from several threads at once.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::RunPooled(const TArray<FNeuralNetworkTensor>& Inputs, UPARAM(ref) TArray<FNeuralNetworkTensor>& Outputs, int32 WaitMilliseconds)
+{
+    using namespace UE::NNE;
+
+    TSharedPtr<FNeuralNetworkInstancePool, ESPMode::ThreadSafe> Pool = InstancePool;
+    if (!Pool.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunPooled failed: CreateInstancePool has not been called"));
+        return false;
+    }
+
+    FNeuralNetworkInstancePool::FLease Lease = Pool->Acquire(WaitMilliseconds < 0 ? MAX_uint32 : static_cast<uint32>(WaitMilliseconds));
+    if (!Lease.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Warning, TEXT("RunPooled: All %d instances are busy"), Pool->Num());
+        return false;
+    }
+
+    FNeuralNetworkInstancePool::FSlot& Slot = Lease.GetSlot();
+    if (Slot.Instance->GetInputTensorDescs().Num() != Inputs.Num() || Slot.Instance->GetOutputTensorDescs().Num() != Outputs.Num())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RunPooled failed: Expected %d inputs and %d outputs, but got %d and %d"),
+            Slot.Instance->GetInputTensorDescs().Num(), Slot.Instance->GetOutputTensorDescs().Num(), Inputs.Num(), Outputs.Num());
+        return false;
+    }
+
+    TArray<FTensorShape, TInlineAllocator<4>> Shapes;
+    Slot.InputBindings.SetNum(Inputs.Num());
+    for (int32 i = 0; i < Inputs.Num(); i++)
+    {
+        const TArray<int32>& Shape = Inputs[i].Shape.Num() > 0 ? Inputs[i].Shape : FIXED_INPUT_SHAPE;
+        Shapes.Add(FTensorShape::MakeFromSymbolic(FSymbolicTensorShape::Make(Shape)));
+
+        Slot.InputBindings[i].Data = (void*)Inputs[i].Data.GetData();
+        Slot.InputBindings[i].SizeInBytes = Inputs[i].Data.Num() * sizeof(float);
+    }
+
+    Slot.OutputBindings.SetNum(Outputs.Num());
+    for (int32 i = 0; i < Outputs.Num(); i++)
+    {
+        if (Outputs[i].Data.Num() == 0)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RunPooled failed: Output tensor at index %d is empty"), i);
+            return false;
+        }
+
+        Slot.OutputBindings[i].Data = (void*)Outputs[i].Data.GetData();
+        Slot.OutputBindings[i].SizeInBytes = Outputs[i].Data.Num() * sizeof(float);
+    }
+
+    return Lease.Run(Shapes, Slot.InputBindings, Slot.OutputBindings);
+}
+
+/*
+ - Parameters:
+    1) Pixels: Raw 8 bit pixels, 4 bytes per pixel, rows tightly packed.
+    2) Width, Height: Size of the image in pixels.
+    3) Format: Channel order of the pixels.
+    4) Settings: Decode settings.
+    5) Detections: Receives the detections in source image pixels.
+ - What it does: Blueprint entry point of DetectImage.
+ - Return Value: bool indicating whether Detections holds a result for the frame.
+ */
+bool UNeuralNetworkModel::Detect(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    if (Width <= 0 || Height <= 0 || Pixels.Num() < Width * Height * 4)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Detect failed: %d bytes is not a %dx%d image"), Pixels.Num(), Width, Height);
+        return false;
+    }
+
+    FNeuralNetworkImageView Image;
+    Image.Pixels = Pixels.GetData();
+    Image.Width = Width;
+    Image.Height = Height;
+    Image.RowStride = Width * 4;
+    Image.Format = Format;
+    return DetectImage(Image, Settings, Detections);
+}
+
+/*
+ - Parameters:
+    1) Image: The frame to run on.
+    2) Settings: Decode settings.
+    3) Detections: Receives the detections in source image pixels.
+ - What it does: Preprocesses, binds, runs and decodes one frame on ModelInstance, reusing its staging memory between
+   calls. With the change gate enabled a frame that barely differs from the last one run returns the previous
+   detections without running the network.
+ - Return Value: bool indicating whether Detections holds a result for the frame.
+ */
+bool UNeuralNetworkModel::DetectImage(const FNeuralNetworkImageView& Image, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    if (!ModelInstance.IsValid() || bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Detect failed: Model instance is invalid or a RunAsync call is in flight"));
+        return false;
+    }
+
+    if (ModelInstance->GetInputTensorDescs().Num() != 1)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Detect failed: Expected a single image input, but the model has %d inputs"), ModelInstance->GetInputTensorDescs().Num());
+        return false;
+    }
+
+    if (Recorder.IsValid() && RecordingFormat == ENeuralNetworkRecordingFormat::Pixels)
+    {
+        RecordFrame(Image, nullptr);
+    }
+
+    if (ChangeGate.IsValid() && !ChangeGate->ShouldRun(Image))
+    {
+        Detections = LastDetections;
+        return true;
+    }
+
+    FNeuralNetworkLetterbox Letterbox;
+    const bool bRan = RunDetectFrame(Image, Letterbox);
+    if (bRan && Recorder.IsValid() && RecordingFormat == ENeuralNetworkRecordingFormat::Tensor)
+    {
+        RecordFrame(Image, &Letterbox);
+    }
+
+    const bool bSuccess = bRan && DecodeDetections(DetectOutputs[0], Letterbox, Settings, LastDetections);
+    if (!bSuccess)
+    {
+        // Never hand out stale detections for frames compared against a frame that failed
+        LastDetections.Reset();
+        if (ChangeGate.IsValid())
+        {
+            ChangeGate->Reset();
+        }
+        return false;
+    }
+
+    Detections = LastDetections;
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Input: The image tensor, DetectInput or memory owned by the caller that stays valid during the run.
+    2) InputShape: Its 1x3xHxW shape.
+ - What it does: Prepares the instance for the shape, sizes DetectOutputs for it and runs the model with bindings of
+   its own. The PrepareSession bindings are left untouched, the next RunPrepared switches the instance back.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::RunDetectInput(TConstArrayView<float> Input, TConstArrayView<int32> InputShape)
+{
+    using namespace UE::NNE;
+
+    if (!ModelInstance.IsValid() || bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Detect failed: Model instance is invalid or a RunAsync call is in flight"));
+        return false;
+    }
+
+    if (ModelInstance->GetInputTensorDescs().Num() != 1 || !Input.GetData() || Input.Num() < 1)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Detect failed: Expected a single image input"));
+        return false;
+    }
+
+    // Resolve the output shapes for the input before sizing the outputs
+    const FTensorShape DetectShape = FTensorShape::MakeFromSymbolic(FSymbolicTensorShape::Make(InputShape));
+    if (!ApplyInputShapes(MakeArrayView(&DetectShape, 1)))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Detect failed: Could not set input tensor shapes"));
+        return false;
+    }
+
+    TConstArrayView<FTensorShape> OutputShapes = ModelInstance->GetOutputTensorShapes();
+    const int32 NumOutputs = OutputShapes.Num();
+    DetectOutputs.SetNum(NumOutputs);
+    DetectOutputBindings.SetNum(NumOutputs, false);
+    for (int32 i = 0; i < NumOutputs; i++)
+    {
+        TArray<int32> Shape;
+        for (uint32 Dim : OutputShapes[i].GetData())
+        {
+            Shape.Add(static_cast<int32>(Dim));
+        }
+        const int32 Volume = static_cast<int32>(OutputShapes[i].Volume());
+        if (DetectOutputs[i].Data.Num() != Volume)
+        {
+            DetectOutputs[i].Data.SetNumUninitialized(Volume);
+        }
+        DetectOutputs[i].Shape = MoveTemp(Shape);
+
+        DetectOutputBindings[i].Data = DetectOutputs[i].Data.GetData();
+        DetectOutputBindings[i].SizeInBytes = Volume * sizeof(float);
+    }
+
+    FTensorBindingCPU DetectInputBinding;
+    DetectInputBinding.Data = (void*)Input.GetData();
+    DetectInputBinding.SizeInBytes = Input.Num() * sizeof(float);
+
+    NEURAL_NETWORK_SCOPE(Run);
+
+    if (ModelInstance->RunSync(MakeArrayView(&DetectInputBinding, 1), DetectOutputBindings) != EResultStatus::Ok)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Detect failed: Model execution returned an error"));
+        return false;
+    }
+
+    INC_DWORD_STAT(STAT_NeuralNetwork_Inferences);
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Image: The frame, or crop of a frame, to run.
+    2) OutLetterbox: Receives the mapping back to the image.
+ - What it does: Letterboxes the image into DetectInput at the size picked by the resolution controller (or the
+   model's own input size without one) and runs it. The run time is fed back to the controller. If the picked size
+   cannot be applied, adaptive resolution is disabled and the frame runs at the model's own size.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::RunDetectFrame(const FNeuralNetworkImageView& Image, FNeuralNetworkLetterbox& OutLetterbox)
+{
+    using namespace UE::NNE;
+
+    if (ResolutionController.IsValid())
+    {
+        const int32 Size = ResolutionController->GetInputSize();
+        DetectInput.Shape = { 1, 3, Size, Size };
+
+        // A size the runtime rejects ends adaptive resolution, the frame runs at the model's own size instead
+        const FTensorShape SizeShape = FTensorShape::MakeFromSymbolic(FSymbolicTensorShape::Make(DetectInput.Shape));
+        if (ModelInstance.IsValid() && !bRunInFlight && !ApplyInputShapes(MakeArrayView(&SizeShape, 1)))
+        {
+            UE_LOG(LogNeuralNetwork, Warning, TEXT("Detect: Input size %d could not be applied, disabling adaptive resolution"), Size);
+            DisableAdaptiveResolution();
+        }
+    }
+    else
+    {
+        DetectInput.Shape = GetImageInputShape();
+    }
+
+    if (!PreprocessImage(Image, DetectInput, OutLetterbox))
+    {
+        return false;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    if (!RunDetectInput(DetectInput.Data, DetectInput.Shape))
+    {
+        return false;
+    }
+
+    if (ResolutionController.IsValid())
+    {
+        ResolutionController->ReportLatency((FPlatformTime::Seconds() - StartTime) * 1000.0);
+    }
+    return true;
+}
+
+/*
+ - Parameters:
+    1) LeftPixels, RightPixels: Raw 8 bit pixels of the two eye views, 4 bytes per pixel, rows tightly packed.
+    2) Width, Height: Size of each eye view in pixels.
+    3) Format: Channel order of the pixels.
+    4) Settings: Decode settings.
+    5) StereoSettings: Layout and cross-eye filtering.
+    6) Detections: Receives the detections of both eyes in their own source pixels, tagged with ViewIndex.
+ - What it does: Blueprint entry point of DetectStereoImages.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::DetectStereo(const TArray<uint8>& LeftPixels, const TArray<uint8>& RightPixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format,
+    const FNeuralNetworkDecodeSettings& Settings, const FNeuralNetworkStereoSettings& StereoSettings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    if (Width <= 0 || Height <= 0 || LeftPixels.Num() < Width * Height * 4 || RightPixels.Num() < Width * Height * 4)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectStereo failed: The eye buffers are not %dx%d images"), Width, Height);
+        return false;
+    }
+
+    FNeuralNetworkImageView Left;
+    Left.Pixels = LeftPixels.GetData();
+    Left.Width = Width;
+    Left.Height = Height;
+    Left.RowStride = Width * 4;
+    Left.Format = Format;
+
+    FNeuralNetworkImageView Right = Left;
+    Right.Pixels = RightPixels.GetData();
+
+    return DetectStereoImages(Left, Right, Settings, StereoSettings, Detections);
+}
+
+/*
+ - Parameters:
+    1) Left, Right: The two eye views.
+    2) Settings: Decode settings, applied per eye.
+    3) StereoSettings: Layout and cross-eye filtering.
+    4) Detections: Receives the detections of both eyes in their own source pixels, tagged with ViewIndex.
+ - What it does: Preprocesses both eyes in parallel and runs them through the model in one call, either as a batch of 2
+   or side by side in one input. Optionally drops detections seen by only one eye.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::DetectStereoImages(const FNeuralNetworkImageView& Left, const FNeuralNetworkImageView& Right, const FNeuralNetworkDecodeSettings& Settings,
+    const FNeuralNetworkStereoSettings& StereoSettings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    Detections.Reset();
+
+    if (!ModelInstance.IsValid() || bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectStereo failed: Model instance is invalid or a RunAsync call is in flight"));
+        return false;
+    }
+
+    const TArray<int32> FrameShape = GetImageInputShape();
+    const int32 TargetHeight = FrameShape[2];
+    const int32 TargetWidth = FrameShape[3];
+
+    if (StereoSettings.Layout == ENeuralNetworkStereoLayout::SideBySide)
+    {
+        FNeuralNetworkLetterbox Letterboxes[2];
+        DetectInput.Shape = FrameShape;
+        DetectInput.Data.SetNumUninitialized(3 * TargetWidth * TargetHeight, false);
+        if (!NeuralNetworkStereo::LetterboxSideBySide(Left, Right, TargetWidth, TargetHeight, DetectInput.Data.GetData(), StereoScratch, Letterboxes)
+            || !RunDetectInput(DetectInput.Data, DetectInput.Shape))
+        {
+            return false;
+        }
+
+        // Decode in tensor pixels, the boxes are mapped to their eye afterwards
+        FNeuralNetworkLetterbox TensorSpace;
+        TensorSpace.SourceWidth = TargetWidth;
+        TensorSpace.SourceHeight = TargetHeight;
+        if (!DecodeDetections(DetectOutputs[0], TensorSpace, Settings, Detections))
+        {
+            return false;
+        }
+        NeuralNetworkStereo::SplitSideBySide(Detections, TargetWidth, Letterboxes);
+    }
+    else
+    {
+        const FNeuralNetworkImageView* Views[2] = { &Left, &Right };
+        const int32 FrameVolume = 3 * TargetWidth * TargetHeight;
+        FNeuralNetworkLetterbox Letterboxes[2];
+        bool bPreprocessed[2] = { false, false };
+
+        if (!GetTensorPool()->Resize(StereoInput, 2 * FrameVolume))
+        {
+            return false;
+        }
+        ParallelFor(2, [&](int32 View)
+        {
+            bPreprocessed[View] = NeuralNetworkPreprocess::Letterbox(*Views[View], TargetWidth, TargetHeight, StereoInput.GetData() + View * FrameVolume, Letterboxes[View]);
+        });
+
+        const int32 BatchShape[] = { 2, 3, TargetHeight, TargetWidth };
+        if (!bPreprocessed[0] || !bPreprocessed[1] || !RunBatched(StereoInput, BatchShape, StereoOutputs))
+        {
+            return false;
+        }
+
+        const int32 NumOutputs = StereoOutputs.Num() / 2;
+        TArray<FNeuralNetworkDetection> ViewDetections;
+        for (int32 View = 0; View < 2; View++)
+        {
+            if (!DecodeDetections(StereoOutputs[View * NumOutputs], Letterboxes[View], Settings, ViewDetections))
+            {
+                return false;
+            }
+            for (FNeuralNetworkDetection& Detection : ViewDetections)
+            {
+                Detection.ViewIndex = View;
+            }
+            Detections.Append(ViewDetections);
+        }
+    }
+
+    if (StereoSettings.bCrossEyeFilter)
+    {
+        NeuralNetworkStereo::CrossEyeFilter(Detections, StereoSettings, Settings.bClassAgnosticNms, FMath::Max(Left.Width, Right.Width));
+    }
+
+    return true;
+}
+
+/*
+ - Parameters: None.
+ - What it does: Resolves the model's own shape of one image for input 0: the shape bound by SetInputs, else the
+   exported shape with dynamic dimensions resolved to the fixed YOLOv8 shape. The shape the instance was last prepared
+   for is not used, batched and adaptive runs change it. Falls back to the fixed YOLOv8 shape for anything that is not
+   a 3 channel NCHW input.
+ - Return Value: TArray<int32> {1, 3, Height, Width}.
+ */
+TArray<int32> UNeuralNetworkModel::GetImageInputShape()
+{
+    TArray<int32> FrameShape;
+    if (BoundInputShapes.Num() > 0 && BoundInputShapes[0].Rank() > 0)
+    {
+        for (uint32 Dim : BoundInputShapes[0].GetData())
+        {
+            FrameShape.Add(static_cast<int32>(Dim));
+        }
+    }
+    else if (ModelInstance.IsValid() && ModelInstance->GetInputTensorDescs().Num() > 0)
+    {
+        FrameShape = ResolveSymbolicShape(ModelInstance->GetInputTensorDescs()[0].GetShape().GetData(), FIXED_INPUT_SHAPE);
+    }
+
+    if (FrameShape.Num() != 4 || FrameShape[1] != 3 || FrameShape[2] < 1 || FrameShape[3] < 1)
+    {
+        FrameShape = FIXED_INPUT_SHAPE;
+    }
+    FrameShape[0] = 1;
+    return FrameShape;
+}
+
+/*
+ - Parameters:
+    1) Pixels: Raw 8 bit pixels, 4 bytes per pixel, rows tightly packed.
+    2) Width, Height: Size of the image in pixels.
+    3) Format: Channel order of the pixels.
+    4) Settings: Decode settings, also used for the global NMS.
+    5) TilingSettings: Tile size, overlap and how the tiles are run.
+    6) Detections: Receives the merged detections in source image pixels.
+ - What it does: Blueprint entry point of DetectTiledImage.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::DetectTiled(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format,
+    const FNeuralNetworkDecodeSettings& Settings, const FNeuralNetworkTilingSettings& TilingSettings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    if (Width <= 0 || Height <= 0 || Pixels.Num() < Width * Height * 4)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectTiled failed: %d bytes is not a %dx%d image"), Pixels.Num(), Width, Height);
+        return false;
+    }
+
+    FNeuralNetworkImageView Image;
+    Image.Pixels = Pixels.GetData();
+    Image.Width = Width;
+    Image.Height = Height;
+    Image.RowStride = Width * 4;
+    Image.Format = Format;
+    return DetectTiledImage(Image, Settings, TilingSettings, Detections);
+}
+
+/*
+ - Parameters:
+    1) Image: The full resolution frame.
+    2) Settings: Decode settings, also used for the global NMS.
+    3) TilingSettings: Tile size, overlap and how the tiles are run.
+    4) Detections: Receives the merged detections in source image pixels.
+ - What it does: Splits the frame into overlapping tiles (plus optionally the whole frame), preprocesses them in
+   parallel, runs them as one batch or across the instance pool, decodes every tile into source pixels and merges the
+   results with one NMS over the whole frame. Small objects keep their full resolution instead of being squashed
+   into a single model input.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::DetectTiledImage(const FNeuralNetworkImageView& Image, const FNeuralNetworkDecodeSettings& Settings,
+    const FNeuralNetworkTilingSettings& TilingSettings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    using namespace UE::NNE;
+
+    Detections.Reset();
+
+    if (!ModelInstance.IsValid() || bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectTiled failed: Model instance is invalid or a RunAsync call is in flight"));
+        return false;
+    }
+
+    if (TilingSettings.Execution == ENeuralNetworkTileExecution::Pooled && !InstancePool.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectTiled failed: Pooled execution needs CreateInstancePool"));
+        return false;
+    }
+
+    const TArray<int32> FrameShape = GetImageInputShape();
+    const int32 TargetHeight = FrameShape[2];
+    const int32 TargetWidth = FrameShape[3];
+    const int32 TileVolume = 3 * TargetWidth * TargetHeight;
+
+    NeuralNetworkTiling::ComputeTiles(Image.Width, Image.Height, TilingSettings, Tiles);
+    const FIntRect FullFrame(0, 0, Image.Width, Image.Height);
+    if (TilingSettings.bIncludeFullFrame && !(Tiles.Num() == 1 && Tiles[0] == FullFrame))
+    {
+        Tiles.Add(FullFrame);
+    }
+    const int32 NumTiles = Tiles.Num();
+
+    if (!GetTensorPool()->Resize(TileInput, NumTiles * TileVolume)
+        || !NeuralNetworkTiling::PreprocessTiles(Image, Tiles, TargetWidth, TargetHeight, TileInput.GetData(), TileLetterboxes))
+    {
+        return false;
+    }
+
+    const int32 NumOutputs = ModelInstance->GetOutputTensorDescs().Num();
+    TArray<TArray<FNeuralNetworkDetection>> TileDetections;
+    TileDetections.SetNum(NumTiles);
+    std::atomic<int32> NumFailed{0};
+
+    if (TilingSettings.Execution == ENeuralNetworkTileExecution::Batched)
+    {
+        const int32 BatchShape[] = { NumTiles, 3, TargetHeight, TargetWidth };
+        if (!RunBatched(TileInput, BatchShape, TileOutputs))
+        {
+            return false;
+        }
+
+        ParallelFor(NumTiles, [&](int32 TileIndex)
+        {
+            if (!DecodeDetections(TileOutputs[TileIndex * NumOutputs], TileLetterboxes[TileIndex], Settings, TileDetections[TileIndex]))
+            {
+                NumFailed++;
+            }
+        });
+    }
+    else
+    {
+        TArray<uint32, TInlineAllocator<4>> ConcreteShape;
+        for (int32 Dim : FrameShape)
+        {
+            ConcreteShape.Add(static_cast<uint32>(Dim));
+        }
+        const FTensorShape TileShape = FTensorShape::Make(ConcreteShape);
+
+        // Per tile outputs sized by a pooled instance prepared for one tile, ModelInstance may be prepared for a batch
+        TArray<TArray<int32>, TInlineAllocator<4>> OutputShapes;
+        {
+            FNeuralNetworkInstancePool::FLease Lease = InstancePool->Acquire(MAX_uint32);
+            if (!Lease.IsValid() || !Lease.Prepare(MakeArrayView(&TileShape, 1)))
+            {
+                UE_LOG(LogNeuralNetwork, Error, TEXT("DetectTiled failed: Could not prepare a pooled instance for %dx%d tiles"), TargetWidth, TargetHeight);
+                return false;
+            }
+            for (const FTensorShape& Shape : Lease.GetSlot().Instance->GetOutputTensorShapes())
+            {
+                TArray<int32>& OutputShape = OutputShapes.AddDefaulted_GetRef();
+                for (uint32 Dim : Shape.GetData())
+                {
+                    OutputShape.Add(static_cast<int32>(Dim));
+                }
+            }
+        }
+
+        if (OutputShapes.Num() != NumOutputs)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("DetectTiled failed: The pooled instance has %d outputs, expected %d"), OutputShapes.Num(), NumOutputs);
+            return false;
+        }
+
+        TileOutputs.SetNum(NumTiles * NumOutputs);
+        for (int32 o = 0; o < NumOutputs; o++)
+        {
+            int32 Volume = 1;
+            for (int32 Dim : OutputShapes[o])
+            {
+                Volume *= Dim;
+            }
+            for (int32 t = 0; t < NumTiles; t++)
+            {
+                TileOutputs[t * NumOutputs + o].Shape = OutputShapes[o];
+                TileOutputs[t * NumOutputs + o].Data.SetNumUninitialized(Volume, false);
+            }
+        }
+
+        TSharedPtr<FNeuralNetworkInstancePool, ESPMode::ThreadSafe> Pool = InstancePool;
+        ParallelFor(NumTiles, [&](int32 TileIndex)
+        {
+            const FTensorBindingCPU InputBinding{ TileInput.GetData() + TileIndex * TileVolume, TileVolume * sizeof(float) };
+            TArray<FTensorBindingCPU, TInlineAllocator<4>> TileOutputBindings;
+            for (int32 o = 0; o < NumOutputs; o++)
+            {
+                FNeuralNetworkTensor& Output = TileOutputs[TileIndex * NumOutputs + o];
+                TileOutputBindings.Add(FTensorBindingCPU{ Output.Data.GetData(), Output.Data.Num() * sizeof(float) });
+            }
+
+            FNeuralNetworkInstancePool::FLease Lease = Pool->Acquire(MAX_uint32);
+            const bool bRan = Lease.Run(MakeArrayView(&TileShape, 1), MakeArrayView(&InputBinding, 1), TileOutputBindings);
+            Lease.Release();
+
+            if (!bRan || !DecodeDetections(TileOutputs[TileIndex * NumOutputs], TileLetterboxes[TileIndex], Settings, TileDetections[TileIndex]))
+            {
+                NumFailed++;
+            }
+        });
+    }
+
+    if (NumFailed > 0)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectTiled failed: %d of %d tiles could not be run or decoded"), NumFailed.load(), NumTiles);
+        return false;
+    }
+
+    {
+        NEURAL_NETWORK_SCOPE(Postprocess);
+
+        for (int32 t = 0; t < NumTiles; t++)
+        {
+            NeuralNetworkTiling::OffsetDetections(TileDetections[t], Tiles[t]);
+            Detections.Append(TileDetections[t]);
+        }
+        NeuralNetworkDetection::NonMaxSuppression(Detections, Settings, FVector2D(Image.Width, Image.Height));
+    }
+
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("DetectTiled: %d tiles, %d detections after merging"), NumTiles, Detections.Num());
+    return true;
+}
+
+/*
+ - Parameters:
+    1) SequenceSettings: The frames, the output file, the batch size and how many frames may be in flight.
+    2) Settings: Decode settings.
+    3) Stats: Receives frame and detection counts and the throughput.
+ - What it does: Streams the frames through FNeuralNetworkImageSequenceReader, which reads and decodes ahead on the
+   task graph, packs them into batches for RunBatched and decodes every frame of a batch in file order. Detections are
+   appended to the sink as soon as their batch is done, so memory stays bounded however long the sequence is.
+ - Return Value: bool indicating whether the sequence was processed, frames that failed to decode do not count as failure.
+ */
+bool UNeuralNetworkModel::DetectImageSequence(const FNeuralNetworkImageSequenceSettings& SequenceSettings, const FNeuralNetworkDecodeSettings& Settings, FNeuralNetworkImageSequenceStats& Stats)
+{
+    check(IsInGameThread());
+
+    Stats = FNeuralNetworkImageSequenceStats();
+
+    if (!ModelInstance.IsValid() || bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectImageSequence failed: Model instance is invalid or a RunAsync call is in flight"));
+        return false;
+    }
+
+    TArray<FString> Files = SequenceSettings.Files.Num() > 0 ? SequenceSettings.Files : FNeuralNetworkImageSequenceReader::FindFrames(SequenceSettings.Directory);
+    if (Files.Num() == 0)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectImageSequence failed: No frames found in '%s'"), *SequenceSettings.Directory);
+        return false;
+    }
+
+    FNeuralNetworkDetectionSink Sink;
+    if (!SequenceSettings.OutputPath.IsEmpty() && !Sink.Open(SequenceSettings.OutputPath))
+    {
+        return false;
+    }
+
+    const TArray<int32> FrameShape = GetImageInputShape();
+    const int32 TargetHeight = FrameShape[2];
+    const int32 TargetWidth = FrameShape[3];
+    const int32 FrameVolume = 3 * TargetWidth * TargetHeight;
+    const int32 NumOutputs = ModelInstance->GetOutputTensorDescs().Num();
+
+    int32 BatchSize = FMath::Max(1, SequenceSettings.BatchSize);
+    const int32 MaxFramesInFlight = FMath::Max(SequenceSettings.MaxFramesInFlight, BatchSize);
+    const TSharedPtr<FNeuralNetworkTensorPool, ESPMode::ThreadSafe> Pool = GetTensorPool();
+
+    UE_LOG(LogNeuralNetwork, Log, TEXT("DetectImageSequence: %d frames, batches of %d, %d frames in flight"), Files.Num(), BatchSize, MaxFramesInFlight);
+
+    const double StartTime = FPlatformTime::Seconds();
+    FNeuralNetworkImageSequenceReader Reader(MoveTemp(Files), TargetWidth, TargetHeight, MaxFramesInFlight, Pool);
+
+    TArray<FNeuralNetworkSequenceFrame> Batch;
+    FNeuralNetworkTensorPool::FBuffer BatchBuffer;
+    TArray<FNeuralNetworkTensor> FrameOutputs;
+    TArray<FNeuralNetworkDetection> Detections;
+    bool bBatchingChecked = false;
+
+    auto RunFrames = [&](TArrayView<FNeuralNetworkSequenceFrame> Frames) -> bool
+    {
+        const int32 NumFrames = Frames.Num();
+        TConstArrayView<float> Input = Frames[0].Tensor;
+        if (NumFrames > 1)
+        {
+            if (!Pool->Resize(BatchBuffer, NumFrames * FrameVolume))
+            {
+                return false;
+            }
+            for (int32 f = 0; f < NumFrames; f++)
+            {
+                FMemory::Memcpy(BatchBuffer.GetData() + f * FrameVolume, Frames[f].Tensor.GetData(), FrameVolume * sizeof(float));
+            }
+            Input = BatchBuffer;
+        }
+
+        const int32 BatchShape[] = { NumFrames, 3, TargetHeight, TargetWidth };
+        return RunBatched(Input, BatchShape, FrameOutputs);
+    };
+
+    // Only after a successful run, so a frame is never written or counted twice
+    auto WriteFrames = [&](TArrayView<FNeuralNetworkSequenceFrame> Frames) -> bool
+    {
+        for (int32 f = 0; f < Frames.Num(); f++)
+        {
+            if (!DecodeDetections(FrameOutputs[f * NumOutputs], Frames[f].Letterbox, Settings, Detections))
+            {
+                return false;
+            }
+            Stats.Detections += Detections.Num();
+            Sink.Write(Frames[f].Index, Frames[f].Path, Detections);
+        }
+        return true;
+    };
+
+    auto RunPendingFrames = [&]() -> bool
+    {
+        bool bSuccess = RunFrames(Batch);
+        if (bSuccess)
+        {
+            bSuccess = WriteFrames(Batch);
+        }
+        else if (!bBatchingChecked && Batch.Num() > 1)
+        {
+            // The first batch tells whether the model takes a batch dimension at all
+            UE_LOG(LogNeuralNetwork, Warning, TEXT("DetectImageSequence: The model does not run batches of %d, running one frame at a time"), Batch.Num());
+            BatchSize = 1;
+            bSuccess = true;
+            for (int32 f = 0; f < Batch.Num() && bSuccess; f++)
+            {
+                const TArrayView<FNeuralNetworkSequenceFrame> Single(&Batch[f], 1);
+                bSuccess = RunFrames(Single) && WriteFrames(Single);
+            }
+        }
+        bBatchingChecked = true;
+        Batch.Reset();
+        return bSuccess;
+    };
+
+    double WaitSeconds = 0.0;
+    FNeuralNetworkSequenceFrame Frame;
+    for (;;)
+    {
+        const double WaitStart = FPlatformTime::Seconds();
+        const bool bHasFrame = Reader.Next(Frame);
+        WaitSeconds += FPlatformTime::Seconds() - WaitStart;
+
+        if (bHasFrame)
+        {
+            Stats.Frames++;
+            if (Frame.bValid)
+            {
+                Batch.Add(MoveTemp(Frame));
+            }
+            else
+            {
+                Stats.FailedFrames++;
+            }
+        }
+
+        if ((Batch.Num() >= BatchSize || (!bHasFrame && Batch.Num() > 0)) && !RunPendingFrames())
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("DetectImageSequence failed: Inference failed after %d frames"), Stats.Frames);
+            return false;
+        }
+
+        if (!bHasFrame)
+        {
+            break;
+        }
+    }
+
+    Stats.Seconds = static_cast<float>(FPlatformTime::Seconds() - StartTime);
+    Stats.WaitSeconds = static_cast<float>(WaitSeconds);
+    Stats.FramesPerSecond = Stats.Seconds > 0.0f ? Stats.Frames / Stats.Seconds : 0.0f;
+
+    UE_LOG(LogNeuralNetwork, Log, TEXT("DetectImageSequence: %d frames (%d failed) in %.2f s, %.1f frames/s, %.2f s waiting for frames, %d detections"),
+        Stats.Frames, Stats.FailedFrames, Stats.Seconds, Stats.FramesPerSecond, Stats.WaitSeconds, Stats.Detections);
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Pixels: Raw 8 bit pixels, 4 bytes per pixel, rows tightly packed.
+    2) Width, Height: Size of the image in pixels.
+    3) Format: Channel order of the pixels.
+    4) Settings: Decode settings of the detector frames.
+    5) Detections: Receives the tracked boxes in source image pixels.
+ - What it does: Blueprint entry point of DetectTrackedImage.
+ - Return Value: bool indicating whether Detections holds a result for the frame.
+ */
+bool UNeuralNetworkModel::DetectTracked(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format,
+    const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    if (Width <= 0 || Height <= 0 || Pixels.Num() < Width * Height * 4)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectTracked failed: %d bytes is not a %dx%d image"), Pixels.Num(), Width, Height);
+        return false;
+    }
+
+    FNeuralNetworkImageView Image;
+    Image.Pixels = Pixels.GetData();
+    Image.Width = Width;
+    Image.Height = Height;
+    Image.RowStride = Width * 4;
+    Image.Format = Format;
+    return DetectTrackedImage(Image, Settings, Detections);
+}
+
+/*
+ - Parameters:
+    1) Image: The frame.
+    2) Settings: Decode settings of the detector frames.
+    3) Detections: Receives the tracked boxes in source image pixels, TrackId set and Score holding the track confidence.
+ - What it does: Moves the tracks onto the frame and runs DetectImage only when the tracker asks for it, so most
+   frames cost a few block matches instead of an inference. A failed detector frame resets the tracker.
+ - Return Value: bool indicating whether Detections holds a result for the frame.
+ */
+bool UNeuralNetworkModel::DetectTrackedImage(const FNeuralNetworkImageView& Image, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    if (!Tracker.IsValid())
+    {
+        return DetectImage(Image, Settings, Detections);
+    }
+
+    if (Tracker->BeginFrame(Image))
+    {
+        if (!DetectImage(Image, Settings, TrackerInput))
+        {
+            Tracker->Reset();
+            Detections.Reset();
+            return false;
+        }
+        Tracker->Correct(TrackerInput);
+    }
+
+    Tracker->GetDetections(Detections);
+    return true;
+}
+
+/*
+ - Parameters:
+    1) RuntimeName: CPU runtime of the classifier, "Auto" selects one like CreateModel does.
+    2) ClassifierData: The second stage model, nullptr removes the current classifier.
+ - What it does: Creates the classifier DetectCascade runs on the detector's crops. It is a model of its own, owned by
+   this one, so it has its own instance and never disturbs the detector's prepared shapes.
+ - Return Value: bool indicating whether the classifier is ready.
+ */
+bool UNeuralNetworkModel::SetClassifier(FString RuntimeName, UNNEModelData* ClassifierData)
+{
+    bClassifierBatching = true;
+    if (!ClassifierData)
+    {
+        Classifier = nullptr;
+        return true;
+    }
+
+    UNeuralNetworkModel* NewClassifier = CreateModel(this, RuntimeName, ClassifierData);
+    if (!NewClassifier)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("SetClassifier failed: Could not create the classifier from %s"), *ClassifierData->GetName());
+        return false;
+    }
+
+    const TArray<int32> InputShape = NewClassifier->GetInputShape(0);
+    if (NewClassifier->NumInputs() != 1 || InputShape.Num() != 4 || InputShape[1] != 3)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("SetClassifier failed: The classifier needs a single Nx3xHxW input"));
+        return false;
+    }
+
+    Classifier = NewClassifier;
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Pixels: Raw 8 bit pixels, 4 bytes per pixel, rows tightly packed.
+    2) Width, Height: Size of the image in pixels.
+    3) Format: Channel order of the pixels.
+    4) Settings: Decode settings of the detector.
+    5) CascadeSettings: Crop selection and classifier input settings.
+    6) Detections: Receives the detections in source image pixels, classified ones with SubClassId set.
+ - What it does: Blueprint entry point of DetectCascadeImage.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::DetectCascade(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format,
+    const FNeuralNetworkDecodeSettings& Settings, const FNeuralNetworkCascadeSettings& CascadeSettings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    if (Width <= 0 || Height <= 0 || Pixels.Num() < Width * Height * 4)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectCascade failed: %d bytes is not a %dx%d image"), Pixels.Num(), Width, Height);
+        return false;
+    }
+
+    FNeuralNetworkImageView Image;
+    Image.Pixels = Pixels.GetData();
+    Image.Width = Width;
+    Image.Height = Height;
+    Image.RowStride = Width * 4;
+    Image.Format = Format;
+    return DetectCascadeImage(Image, Settings, CascadeSettings, Detections);
+}
+
+/*
+ - Parameters:
+    1) Image: The frame.
+    2) Settings: Decode settings of the detector.
+    3) CascadeSettings: Crop selection and classifier input settings.
+    4) Detections: Receives the detections in source image pixels, classified ones with SubClassId set.
+ - What it does: DetectImage followed by ClassifyDetections on the same frame.
+ - Return Value: bool indicating whether both stages were successful.
+ */
+bool UNeuralNetworkModel::DetectCascadeImage(const FNeuralNetworkImageView& Image, const FNeuralNetworkDecodeSettings& Settings,
+    const FNeuralNetworkCascadeSettings& CascadeSettings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    return DetectImage(Image, Settings, Detections) && ClassifyDetections(Image, CascadeSettings, Detections);
+}
+
+/*
+ - Parameters:
+    1) Image: The frame the detections belong to.
+    2) CascadeSettings: Crop selection and classifier input settings.
+    3) Detections: The detections, SubClassId and SubClassScore are filled in for the classified ones.
+ - What it does: Crops and resizes up to MaxCrops boxes in one parallel pass into a single pooled batch and runs the
+   classifier once on all of them. A classifier without a dynamic batch dimension is detected on the first call and
+   run once per crop from then on.
+ - Return Value: bool indicating whether the classifier ran successfully.
+ */
+bool UNeuralNetworkModel::ClassifyDetections(const FNeuralNetworkImageView& Image, const FNeuralNetworkCascadeSettings& CascadeSettings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    using namespace NeuralNetworkCascade;
+
+    for (FNeuralNetworkDetection& Detection : Detections)
+    {
+        Detection.SubClassId = INDEX_NONE;
+        Detection.SubClassScore = 0.0f;
+    }
+
+    if (!Classifier)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("ClassifyDetections failed: No classifier, call SetClassifier first"));
+        return false;
+    }
+
+    if (!Image.Pixels || Image.Width < 1 || Image.Height < 1)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("ClassifyDetections failed: Invalid image"));
+        return false;
+    }
+
+    SelectCrops(Detections, CascadeSettings, CascadeCrops);
+    const int32 NumCrops = CascadeCrops.Num();
+    if (NumCrops == 0)
+    {
+        return true;
+    }
+
+    if (!Classifier->ModelInstance.IsValid() || Classifier->ModelInstance->GetInputTensorDescs().Num() < 1)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("ClassifyDetections failed: Classifier instance is invalid, the model may still be loading"));
+        return false;
+    }
+
+    // Dynamic height and width take InputSize, GetInputShape would resolve them to the detector's fixed shape
+    const int32 CropSize = FMath::Max(1, CascadeSettings.InputSize);
+    const TArray<int32> InputShape = ResolveSymbolicShape(Classifier->ModelInstance->GetInputTensorDescs()[0].GetShape().GetData(), { 1, 3, CropSize, CropSize });
+    if (InputShape.Num() != 4 || InputShape[1] != 3)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("ClassifyDetections failed: The classifier input has rank %d, expected a 3 channel NCHW image"), InputShape.Num());
+        return false;
+    }
+    const int32 CropHeight = InputShape[2];
+    const int32 CropWidth = InputShape[3];
+    const int32 CropVolume = 3 * CropWidth * CropHeight;
+
+    if (!GetTensorPool()->Resize(CascadeInput, NumCrops * CropVolume))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("ClassifyDetections failed: Could not allocate %d crops"), NumCrops);
+        return false;
+    }
+    PackCrops(Image, Detections, CascadeCrops, CropWidth, CropHeight, CascadeSettings, CascadeInput.GetData());
+
+    auto RunCrops = [&](int32 First, int32 Count) -> bool
+    {
+        const int32 BatchShape[] = { Count, 3, CropHeight, CropWidth };
+        const TConstArrayView<float> Input(CascadeInput.GetData() + static_cast<int64>(First) * CropVolume, Count * CropVolume);
+        if (!Classifier->RunBatched(Input, BatchShape, CascadeOutputs))
+        {
+            return false;
+        }
+
+        NEURAL_NETWORK_SCOPE(Postprocess);
+
+        const int32 NumOutputs = CascadeOutputs.Num() / Count;
+        for (int32 i = 0; i < Count; i++)
+        {
+            const FNeuralNetworkTensor& Scores = CascadeOutputs[i * NumOutputs];
+            FNeuralNetworkDetection& Detection = Detections[CascadeCrops[First + i]];
+            ReadClass(Scores.Data.GetData(), Scores.Data.Num(), CascadeSettings.bApplySoftmax, Detection.SubClassId, Detection.SubClassScore);
+        }
+        return true;
+    };
+
+    if (bClassifierBatching || NumCrops == 1)
+    {
+        if (RunCrops(0, NumCrops))
+        {
+            return true;
+        }
+        if (NumCrops == 1)
+        {
+            return false;
+        }
+
+        UE_LOG(LogNeuralNetwork, Warning, TEXT("ClassifyDetections: The classifier does not run batches of %d, running one crop at a time"), NumCrops);
+        bClassifierBatching = false;
+    }
+
+    for (int32 i = 0; i < NumCrops; i++)
+    {
+        if (!RunCrops(i, 1))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ - Parameters:
+    1) Pixels: Raw 8 bit pixels, 4 bytes per pixel, rows tightly packed.
+    2) Width, Height: Size of the image in pixels.
+    3) Format: Channel order of the pixels.
+    4) Settings: Decode settings, also used to merge the two passes.
+    5) FoveationSettings: Crop size and full frame rate.
+    6) Detections: Receives the merged detections in source image pixels.
+ - What it does: Blueprint entry point of DetectFoveatedImage.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::DetectFoveated(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format,
+    const FNeuralNetworkDecodeSettings& Settings, const FNeuralNetworkFoveationSettings& FoveationSettings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    if (Width <= 0 || Height <= 0 || Pixels.Num() < Width * Height * 4)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectFoveated failed: %d bytes is not a %dx%d image"), Pixels.Num(), Width, Height);
+        return false;
+    }
+
+    FNeuralNetworkImageView Image;
+    Image.Pixels = Pixels.GetData();
+    Image.Width = Width;
+    Image.Height = Height;
+    Image.RowStride = Width * 4;
+    Image.Format = Format;
+    return DetectFoveatedImage(Image, Settings, FoveationSettings, Detections);
+}
+
+/*
+ - Parameters:
+    1) Image: The full resolution frame.
+    2) Settings: Decode settings, also used to merge the two passes.
+    3) FoveationSettings: Crop size and full frame rate.
+    4) Detections: Receives the merged detections in source image pixels.
+ - What it does: Runs a crop of FoveationSettings.CropSize around the current gaze point every frame, and the whole
+   frame scaled down to the model input every FullFrameInterval frames. Inside the crop only the crop's detections
+   are used, outside it the most recent full frame detections fill in. Both passes use the same input shape, so
+   alternating between them never re-plans the instance.
+ - Return Value: bool indicating whether the inference was successful.
+ */
+bool UNeuralNetworkModel::DetectFoveatedImage(const FNeuralNetworkImageView& Image, const FNeuralNetworkDecodeSettings& Settings,
+    const FNeuralNetworkFoveationSettings& FoveationSettings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    Detections.Reset();
+
+    if (!ModelInstance.IsValid() || bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectFoveated failed: Model instance is invalid or a RunAsync call is in flight"));
+        return false;
+    }
+
+    FNeuralNetworkGazeQuery Query;
+    Query.FrameNumber = FoveatedFrameNumber;
+    Query.TimeSeconds = FPlatformTime::Seconds();
+    Query.FrameWidth = Image.Width;
+    Query.FrameHeight = Image.Height;
+
+    FVector2D Gaze(0.5, 0.5);
+    if (GazeSource.IsValid() && !GazeSource->GetGaze(Query, Gaze))
+    {
+        Gaze = FVector2D(0.5, 0.5);
+    }
+
+    const FIntRect Fovea = NeuralNetworkFoveation::ComputeFoveaRect(Image.Width, Image.Height, Gaze, FoveationSettings.CropSize);
+    const bool bCropIsFrame = Fovea.Width() == Image.Width && Fovea.Height() == Image.Height;
+
+    const int32 Interval = FMath::Max(1, FoveationSettings.FullFrameInterval);
+    const bool bRunFullFrame = !bCropIsFrame
+        && (FoveatedFrameNumber % Interval == 0 || FullFrameSize != FIntPoint(Image.Width, Image.Height));
+    FoveatedFrameNumber++;
+
+    FNeuralNetworkLetterbox Letterbox;
+    if (!RunDetectFrame(NeuralNetworkTiling::Crop(Image, Fovea), Letterbox) || !DecodeDetections(DetectOutputs[0], Letterbox, Settings, Detections))
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to create UNeuralNetworkModel instance."));
-        return nullptr;
+        return false;
     }
+    NeuralNetworkTiling::OffsetDetections(Detections, Fovea);
 
-    UE_LOG(LogTemp, Warning, TEXT("Successfully created UNeuralNetworkModel instance."));
-    
-    if (UniqueModel.IsValid())
+    if (bCropIsFrame)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Model is valid after creation."));
+        return true;
     }
-    else
+
+    if (bRunFullFrame)
     {
-        UE_LOG(LogTemp, Error, TEXT("Model is NOT valid after creation."));
+        FullFrameDetections.Reset();
+        FullFrameSize = FIntPoint::ZeroValue;
+        if (!RunDetectFrame(Image, Letterbox) || !DecodeDetections(DetectOutputs[0], Letterbox, Settings, FullFrameDetections))
+        {
+            return false;
+        }
+        FullFrameSize = FIntPoint(Image.Width, Image.Height);
     }
 
-    // Store the model in the created instance
-    Result->Model = UniqueModel;
+    NEURAL_NETWORK_SCOPE(Postprocess);
 
-    // Store the ModelInstance by creating a new instance from the model
-    Result->ModelInstance = UniqueModel->CreateModelInstanceCPU();
-    if (!Result->ModelInstance.IsValid())
+    // Boxes entirely inside the crop were seen at full resolution this frame, everything else comes from the full frame
+    for (const FNeuralNetworkDetection& Detection : FullFrameDetections)
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to create ModelInstance."));
-        return nullptr;
+        const bool bInsideFovea = Detection.Min.X >= Fovea.Min.X && Detection.Min.Y >= Fovea.Min.Y
+            && Detection.Max.X <= Fovea.Max.X && Detection.Max.Y <= Fovea.Max.Y;
+        if (!bInsideFovea)
+        {
+            Detections.Add(Detection);
+        }
     }
+    NeuralNetworkDetection::NonMaxSuppression(Detections, Settings, FVector2D(Image.Width, Image.Height));
 
-    UE_LOG(LogTemp, Warning, TEXT("ModelInstance successfully created and stored in UNeuralNetworkModel."));
+    return true;
+}
 
-    return Result;
+/*
+ - Parameters:
+    1) Gaze: Normalized gaze point.
+ - What it does: Makes DetectFoveated center its crop on the point, replacing any other gaze source.
+ - Return Value: None.
+ */
+void UNeuralNetworkModel::SetGazePoint(FVector2D Gaze)
+{
+    GazeSource = MakeShared<FNeuralNetworkFixedGazeSource>(Gaze);
 }
 
+/*
+ - Parameters:
+    1) Direction: View direction in the capture camera's space (X forward, Y right, Z up).
+    2) HorizontalFovDegrees: Horizontal field of view of the capture camera.
+ - What it does: Makes DetectFoveated center its crop where the direction hits the image, replacing any other gaze source.
+ - Return Value: None.
+ */
+void UNeuralNetworkModel::SetGazeDirection(FVector Direction, float HorizontalFovDegrees)
+{
+    GazeSource = MakeShared<FNeuralNetworkDirectionGazeSource>(Direction, HorizontalFovDegrees);
+}
 
+/*
+ - Parameters:
+    1) FilePath: CSV gaze trace, see FNeuralNetworkGazeTraceSource.
+ - What it does: Drives DetectFoveated from a recorded trace, replacing any other gaze source.
+ - Return Value: bool indicating whether the trace was loaded.
+ */
+bool UNeuralNetworkModel::LoadGazeTrace(const FString& FilePath)
+{
+    TSharedPtr<FNeuralNetworkGazeTraceSource> Trace = FNeuralNetworkGazeTraceSource::LoadFromFile(FilePath);
+    if (!Trace.IsValid())
+    {
+        return false;
+    }
 
-// ######################################################################################################################
+    GazeSource = Trace;
+    return true;
+}
 
 /*
-- Parameters:
- 1) Shape: The shape of the tensor as a TArray<int32>.
- 2) Tensor: A reference to a FNeuralNetworkTensor to be populated.
-- What it does: Allocates memory for a tensor with the specified shape and initializes its data array.
-- Return Value: bool indicating whether the tensor was successfully created.
+ - Parameters:
+    1) Settings: Candidate input sizes, latency budget and hysteresis.
+ - What it does: Lets Detect and DetectFoveated pick their input size per frame to stay within the latency budget. The
+   shape cache is grown to hold one prepared instance per size, so switching back and forth never re-plans the model.
+   Rejected for models whose input height and width are fixed.
+ - Return Value: bool indicating whether adaptive resolution was enabled.
  */
-bool UNeuralNetworkModel::CreateTensor(TArray<int32> Shape, UPARAM(ref) FNeuralNetworkTensor& Tensor)
+bool UNeuralNetworkModel::EnableAdaptiveResolution(const FNeuralNetworkResolutionSettings& Settings)
 {
-    UE_LOG(LogTemp, Warning, TEXT("CreateTensor called with shape: %s"), *FString::JoinBy(Shape, TEXT(", "), [](int32 Val) { return FString::FromInt(Val); }));
-
-    if (Shape.Num() == 0)
+    if (!ModelInstance.IsValid() || ModelInstance->GetInputTensorDescs().Num() < 1)
     {
-        UE_LOG(LogTemp, Error, TEXT("CreateTensor failed: Shape array is empty"));
+        UE_LOG(LogNeuralNetwork, Error, TEXT("EnableAdaptiveResolution failed: Model instance is invalid, the model may still be loading"));
         return false;
     }
 
-    int32 Volume = 1;
-    for (int32 i = 0; i < Shape.Num(); i++)
+    const TConstArrayView<int32> SymbolicShape = ModelInstance->GetInputTensorDescs()[0].GetShape().GetData();
+    if (SymbolicShape.Num() != 4 || SymbolicShape[2] >= 0 || SymbolicShape[3] >= 0)
     {
-        if (Shape[i] < 1)
-        {
-            UE_LOG(LogTemp, Error, TEXT("CreateTensor failed: Invalid shape value at index %d (value: %d)"), i, Shape[i]);
-            return false;
-        }
-        Volume *= Shape[i];
+        UE_LOG(LogNeuralNetwork, Error, TEXT("EnableAdaptiveResolution failed: Input 0 needs a dynamic height and width, the model was exported with a fixed size"));
+        return false;
     }
 
-    UE_LOG(LogTemp, Warning, TEXT("CreateTensor: Allocating tensor with volume %d"), Volume);
-
-    Tensor.Shape = Shape;
-    Tensor.Data.SetNum(Volume);
-
-    UE_LOG(LogTemp, Warning, TEXT("CreateTensor: Successfully created tensor."));
+    ResolutionController = MakeUnique<FNeuralNetworkResolutionController>(Settings);
+    SetShapeCacheSize(FMath::Max(MaxPreparedInstances, Settings.InputSizes.Num()));
     return true;
 }
 
 /*
  - Parameters: None.
- - What it does: Returns the number of input tensors expected by the model.
- - Return Value: int32 representing the number of input tensors.
+ - What it does: Goes back to the model's own input size for Detect and DetectFoveated.
+ - Return Value: None.
  */
-int32 UNeuralNetworkModel::NumInputs()
+void UNeuralNetworkModel::DisableAdaptiveResolution()
 {
-    check(Model.IsValid());
-    int32 Num = ModelInstance->GetInputTensorDescs().Num();
-    UE_LOG(LogTemp, Warning, TEXT("NumInputs called: %d inputs found"), Num);
-    return Num;
+    ResolutionController.Reset();
+    DetectInput.Shape = GetImageInputShape();
 }
 
 /*
  - Parameters: None.
- - What it does: Returns the number of output tensors produced by the model.
- - Return Value: int32 representing the number of output tensors.
+ - What it does: Reports the current input size, the measured latency and how often the budget was missed.
+ - Return Value: FNeuralNetworkResolutionStats, all zero when adaptive resolution is disabled.
  */
-int32 UNeuralNetworkModel::NumOutputs()
+FNeuralNetworkResolutionStats UNeuralNetworkModel::GetResolutionStats() const
 {
-    check(Model.IsValid());
-    int32 Num = ModelInstance->GetOutputTensorDescs().Num();
-    UE_LOG(LogTemp, Warning, TEXT("NumOutputs called: %d outputs found"), Num);
-    return Num;
+    return ResolutionController.IsValid() ? ResolutionController->GetStats() : FNeuralNetworkResolutionStats();
 }
 
 /*
  - Parameters:
-    1) Index: The index of the input tensor.
- - What it does: Returns the fixed input shape (1, 3, 640, 640) required by the YOLOv8 model.
- - Return Value: TArray<int32> representing the input tensor shape.
+    1) Settings: Thresholds of the gate.
+ - What it does: Makes Detect compare each frame with the last frame it ran on and skip the network when the scene did
+   not change. Replaces a gate enabled earlier, which resets the statistics.
+ - Return Value: None.
  */
-TArray<int32> UNeuralNetworkModel::GetInputShape(int32 Index)
+void UNeuralNetworkModel::EnableChangeGate(const FNeuralNetworkChangeGateSettings& Settings)
 {
-    
-    UE_LOG(LogTemp, Warning, TEXT("GetInputShape called, returning fixed shape."));
-    return FIXED_INPUT_SHAPE;
-
+    ChangeGate = MakeUnique<FNeuralNetworkChangeGate>(Settings);
+}
 
-    /*
-     using namespace UE::NNE;
+void UNeuralNetworkModel::DisableChangeGate()
+{
+    ChangeGate.Reset();
+}
 
-    TConstArrayView<FTensorDesc> Desc = ModelInstance->GetInputTensorDescs();
-    if (Index < 0 || Index >= Desc.Num())
-    {
-        UE_LOG(LogTemp, Error, TEXT("GetInputShape failed: Index %d out of bounds"), Index);
-        return TArray<int32>();
-    }
+/*
+ - Parameters: None.
+ - What it does: Reports how many frames the change gate checked and skipped.
+ - Return Value: FNeuralNetworkChangeGateStats, all zero when the gate is disabled.
+ */
+FNeuralNetworkChangeGateStats UNeuralNetworkModel::GetChangeGateStats() const
+{
+    return ChangeGate.IsValid() ? ChangeGate->GetStats() : FNeuralNetworkChangeGateStats();
+}
 
-    TArray<int32> Shape = TArray<int32>(Desc[Index].GetShape().GetData());
-    UE_LOG(LogTemp, Warning, TEXT("GetInputShape called for index %d: Shape = %s"), Index, *FString::JoinBy(Shape, TEXT(", "), [](int32 Val) { return FString::FromInt(Val); }));
+/*
+ - Parameters:
+    1) Settings: Detector cadence, association and motion settings.
+ - What it does: Makes DetectTracked track objects between detector runs. Restarting drops the current tracks.
+ - Return Value: None.
+ */
+void UNeuralNetworkModel::EnableTracking(const FNeuralNetworkTrackerSettings& Settings)
+{
+    Tracker = MakeUnique<FNeuralNetworkTracker>(Settings);
+}
 
-    return Shape;
-    */
+void UNeuralNetworkModel::DisableTracking()
+{
+    Tracker.Reset();
 }
 
-////////////////
+/*
+ - Parameters: None.
+ - What it does: Reports how often the tracker let the detector run and how many objects it follows.
+ - Return Value: FNeuralNetworkTrackerStats, all zero when tracking is disabled.
+ */
+FNeuralNetworkTrackerStats UNeuralNetworkModel::GetTrackerStats() const
+{
+    return Tracker.IsValid() ? Tracker->GetStats() : FNeuralNetworkTrackerStats();
+}
 
 /*
  - Parameters:
-    1) Index: The index of the output tensor.
- - What it does: Returns the fixed output shape (1, 84, 5) expected from the YOLOv8 model.
- - Return Value: TArray<int32> representing the output tensor shape.
+    1) FilePath: The recording to write, replaced if it exists.
+    2) Format: Pixels stores the frames as captured, Tensor stores the preprocessed model input and its letterbox.
+    3) bCompress: LZ4 compress every frame. Tensor frames then have to be decompressed on replay instead of being bound
+       straight from the mapped file.
+ - What it does: Records every frame Detect sees from now on, including frames the change gate skips (Pixels only, a
+   skipped frame has no tensor). Replaces a recording in progress.
+ - Return Value: None.
  */
-TArray<int32> UNeuralNetworkModel::GetOutputShape(int32 Index)
+void UNeuralNetworkModel::StartRecording(const FString& FilePath, ENeuralNetworkRecordingFormat Format, bool bCompress)
 {
-    UE_LOG(LogTemp, Warning, TEXT("GetOutputShape called. Using fixed YOLOv8 output shape."));
+    StopRecording();
 
-    // YOLOv8 output shape: (1, 84, N) where N depends on the number of detections.
-    return {1, 84, 5}; // Adjust '5' as needed based on your model # of trained objects.
+    Recorder = MakeUnique<FNeuralNetworkRecordingWriter>();
+    RecordingPath = FilePath;
+    RecordingFormat = Format;
+    bCompressRecording = bCompress;
 }
 
 /*
-TArray<int32> UNeuralNetworkModel::GetOutputShape(int32 Index)
+ - Parameters: None.
+ - What it does: Finishes the recording started by StartRecording.
+ - Return Value: bool indicating whether a complete recording with at least one frame was written.
+ */
+bool UNeuralNetworkModel::StopRecording()
 {
-    check(Model.IsValid());
+    if (!Recorder.IsValid())
+    {
+        return false;
+    }
 
-    using namespace UE::NNE;
+    const bool bSuccess = Recorder->IsOpen() && Recorder->Num() > 0 && Recorder->Close();
+    Recorder.Reset();
+    return bSuccess;
+}
 
-    TConstArrayView<FTensorDesc> Desc = ModelInstance->GetOutputTensorDescs();
-    if (Index < 0 || Index >= Desc.Num())
+void UNeuralNetworkModel::RecordFrame(const FNeuralNetworkImageView& Image, const FNeuralNetworkLetterbox* Letterbox)
+{
+    NEURAL_NETWORK_SCOPE(Record);
+
+    const bool bTensor = RecordingFormat == ENeuralNetworkRecordingFormat::Tensor;
+    if (!Recorder->IsOpen())
     {
-        UE_LOG(LogTemp, Error, TEXT("GetOutputShape failed: Index %d out of bounds"), Index);
-        return TArray<int32>();
+        const int32 Width = bTensor ? DetectInput.Shape[3] : Image.Width;
+        const int32 Height = bTensor ? DetectInput.Shape[2] : Image.Height;
+        if (!Recorder->Open(RecordingPath, RecordingFormat, Width, Height, bCompressRecording))
+        {
+            // Nothing will ever be recorded, don't retry every frame
+            Recorder.Reset();
+            return;
+        }
     }
 
-    TArray<int32> Shape = TArray<int32>(Desc[Index].GetShape().GetData());
-    UE_LOG(LogTemp, Warning, TEXT("GetOutputShape called for index %d: Shape = %s"), Index, *FString::JoinBy(Shape, TEXT(", "), [](int32 Val) { return FString::FromInt(Val); }));
+    const double CaptureTime = FPlatformTime::Seconds();
+    if (bTensor)
+    {
+        Recorder->WriteTensor(DetectInput.Data, *Letterbox, CaptureTime);
+    }
+    else
+    {
+        Recorder->WriteImage(Image, CaptureTime);
+    }
+}
 
-    return Shape;
+/*
+ - Parameters:
+    1) FilePath: A recording written by StartRecording.
+ - What it does: Memory maps the recording for DetectRecordedFrame, closing the previous one.
+ - Return Value: bool indicating whether the recording is valid.
+ */
+bool UNeuralNetworkModel::OpenRecording(const FString& FilePath)
+{
+    Replay = MakeUnique<FNeuralNetworkRecordingReader>();
+    if (!Replay->Open(FilePath))
+    {
+        Replay.Reset();
+        return false;
+    }
+    return true;
+}
+
+/*
+ - Parameters: None.
+ - What it does: Counts the frames of the recording opened by OpenRecording.
+ - Return Value: int32, 0 without an open recording.
+ */
+int32 UNeuralNetworkModel::GetRecordingFrameCount() const
+{
+    return Replay.IsValid() ? Replay->Num() : 0;
 }
+
+/*
+ - Parameters:
+    1) FrameIndex: The frame of the open recording.
+    2) Settings: Decode settings.
+    3) Detections: Receives the detections in the source pixels of the recorded frame.
+ - What it does: Pixels frames go through DetectImage straight from the mapped file. Uncompressed tensor frames are
+   bound to the model in place and skip preprocessing entirely, so replay measures the network and the decode alone.
+ - Return Value: bool indicating whether Detections holds a result for the frame.
  */
+bool UNeuralNetworkModel::DetectRecordedFrame(int32 FrameIndex, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections)
+{
+    Detections.Reset();
+
+    if (!Replay.IsValid() || FrameIndex < 0 || FrameIndex >= Replay->Num())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectRecordedFrame failed: Frame %d is not in the open recording"), FrameIndex);
+        return false;
+    }
+
+    if (Replay->GetFormat() == ENeuralNetworkRecordingFormat::Pixels)
+    {
+        FNeuralNetworkImageView Image;
+        return Replay->GetImage(FrameIndex, ReplayScratch, Image) && DetectImage(Image, Settings, Detections);
+    }
 
+    if (!ModelInstance.IsValid() || bRunInFlight)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("DetectRecordedFrame failed: Model instance is invalid or a RunAsync call is in flight"));
+        return false;
+    }
 
+    TConstArrayView<float> Tensor;
+    FNeuralNetworkLetterbox Letterbox;
+    if (!Replay->GetTensor(FrameIndex, ReplayScratch, Tensor, Letterbox))
+    {
+        return false;
+    }
 
+    const int32 TensorShape[] = { 1, 3, Replay->GetHeight(), Replay->GetWidth() };
+    return RunDetectInput(Tensor, TensorShape) && DecodeDetections(DetectOutputs[0], Letterbox, Settings, Detections);
+}
 
 /*
  - Parameters:
-    1) Inputs: An array of FNeuralNetworkTensor containing the input tensors.
- - What it does: Assigns the input tensors to the model and sets their shapes for inference.
- - Return Value: bool indicating whether the inputs were successfully set.
+    1) Settings: Decode settings applied to every frame.
+ - What it does: Creates a dedicated model instance prepared for the fixed input shape and a latest-frame-wins queue of
+   preallocated input tensors in front of it. Frames given to SubmitFrame are then run on a worker task and their
+   detections broadcast through OnFrameProcessed. Restarting replaces the previous pipeline.
+ - Return Value: bool indicating whether the pipeline was started.
  */
-bool UNeuralNetworkModel::SetInputs(const TArray<FNeuralNetworkTensor>& Inputs)
+bool UNeuralNetworkModel::StartFramePipeline(const FNeuralNetworkDecodeSettings& Settings)
 {
-    UE_LOG(LogTemp, Warning, TEXT("SetInputs called"));
-    check(Model.IsValid());
+    using namespace UE::NNE;
 
-    UE_LOG(LogTemp, Warning, TEXT("SetInputs called with %d input tensors"), Inputs.Num());
+    check(IsInGameThread());
 
-    using namespace UE::NNE;
+    if (!Model.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("StartFramePipeline failed: Model is invalid!"));
+        return false;
+    }
 
-    InputBindings.Reset();
-    InputShapes.Reset();
-    
-    // Define the fixed input shape (YOLOv8 expects 1x3x640x640)
-    const TArray<int32> FixedShape = {1, 3, 640, 640};
-    const int32 ExpectedNumElements = 1 * 3 * 640 * 640;  // 1,228,800 elements
+    StopFramePipeline();
 
+    TSharedPtr<FNeuralNetworkFramePipeline, ESPMode::ThreadSafe> Pipeline = MakeShared<FNeuralNetworkFramePipeline, ESPMode::ThreadSafe>();
+    Pipeline->Model = Model;
+    Pipeline->Instance = Model->CreateModelInstanceCPU();
+    Pipeline->Settings = Settings;
+    if (!Pipeline->Instance.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("StartFramePipeline failed: Could not create a model instance"));
+        return false;
+    }
 
-    TConstArrayView<FTensorDesc> InputDescs = ModelInstance->GetInputTensorDescs();
-    if (InputDescs.Num() != Inputs.Num())
+    TConstArrayView<FTensorDesc> InputDescs = Pipeline->Instance->GetInputTensorDescs();
+    if (InputDescs.Num() != 1)
     {
-        UE_LOG(LogTemp, Error, TEXT("SetInputs failed: Expected %d input tensors, but got %d"), InputDescs.Num(), Inputs.Num());
+        UE_LOG(LogNeuralNetwork, Error, TEXT("StartFramePipeline failed: Expected a single image input, but the model has %d inputs"), InputDescs.Num());
         return false;
     }
 
-    InputBindings.SetNum(Inputs.Num());
-    InputShapes.SetNum(Inputs.Num());
+    const TArray<int32> InputShape = ResolveSymbolicShape(InputDescs[0].GetShape().GetData(), FIXED_INPUT_SHAPE);
+    if (InputShape.Num() != 4 || InputShape[0] != 1 || InputShape[1] != 3)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("StartFramePipeline failed: Input is not a 1x3xHxW image"));
+        return false;
+    }
 
-    for (int32 i = 0; i < Inputs.Num(); i++)
+    const FTensorShape PreparedShape = FTensorShape::MakeFromSymbolic(FSymbolicTensorShape::Make(InputShape));
+    if (Pipeline->Instance->SetInputTensorShapes(MakeArrayView(&PreparedShape, 1)) != EResultStatus::Ok)
     {
-        
-        
-        // how do i populate the input tensor with the pixel data i got in ProcessRenderTarget
-        
-        // Directly assign the input data, assuming it is already in the correct shape
-        InputBindings[i].Data = (void*)Inputs[i].Data.GetData();
-        InputBindings[i].SizeInBytes = Inputs[i].Data.Num() * sizeof(float);
-        
-        
-        
-        
-        // tests for image loading
-        UE_LOG(LogTemp, Warning, TEXT("SetInputs: InputBindings[i].SizeInBytes %d"),Inputs[i].Data.Num());
-        UE_LOG(LogTemp, Warning, TEXT("SetInputs: (void*)Inputs[i].Data.GetData() %d"), (void*)Inputs[i].Data.GetData());
-
-
-        // Assign the fixed shape to the tensor
-        InputShapes[i] = FTensorShape::MakeFromSymbolic(FSymbolicTensorShape::Make(FixedShape));
-
-        UE_LOG(LogTemp, Warning, TEXT("SetInputs: Tensor %d -> Shape: %s, Size: %d bytes"),
-            i,
-            *FString::JoinBy(FixedShape, TEXT(", "), [](int32 Val) { return FString::FromInt(Val); }),
-            InputBindings[i].SizeInBytes);
+        UE_LOG(LogNeuralNetwork, Error, TEXT("StartFramePipeline failed: Could not set input tensor shapes"));
+        return false;
     }
 
-    if (ModelInstance->SetInputTensorShapes(InputShapes) != UE::NNE::EResultStatus::Ok)
+    TConstArrayView<FTensorShape> OutputShapes = Pipeline->Instance->GetOutputTensorShapes();
+    if (OutputShapes.Num() == 0 || OutputShapes[0].Rank() != 3)
     {
-        UE_LOG(LogTemp, Error, TEXT("SetInputs failed: Could not set input tensor shapes"));
+        UE_LOG(LogNeuralNetwork, Error, TEXT("StartFramePipeline failed: Output 0 is not a 1xCxN detection tensor"));
         return false;
     }
 
-    UE_LOG(LogTemp, Warning, TEXT("SetInputs: Successfully set input tensors with fixed shape."));
+    Pipeline->InputHeight = InputShape[2];
+    Pipeline->InputWidth = InputShape[3];
+    Pipeline->NumChannels = static_cast<int32>(OutputShapes[0].GetData()[1]);
+    Pipeline->NumAnchors = static_cast<int32>(OutputShapes[0].GetData()[2]);
+
+    Pipeline->OutputData.SetNum(OutputShapes.Num());
+    Pipeline->OutputBindings.SetNum(OutputShapes.Num());
+    for (int32 i = 0; i < OutputShapes.Num(); i++)
+    {
+        Pipeline->OutputData[i].SetNumUninitialized(static_cast<int32>(OutputShapes[i].Volume()));
+        Pipeline->OutputBindings[i].Data = Pipeline->OutputData[i].GetData();
+        Pipeline->OutputBindings[i].SizeInBytes = Pipeline->OutputData[i].Num() * sizeof(float);
+    }
+
+    Pipeline->Queue.Allocate(3 * Pipeline->InputWidth * Pipeline->InputHeight);
+
+    FramePipeline = MoveTemp(Pipeline);
     return true;
 }
 
 /*
- - Parameters:
-    1) Outputs: A reference to an array of FNeuralNetworkTensor to store the model's output.
- - What it does: Runs the model synchronously using the provided inputs and populates the output tensors.
- - Return Value: bool indicating whether the inference was successful.
+ - Parameters: None.
+ - What it does: Stops the frame pipeline. A frame already running finishes on the worker but is not broadcast.
+ - Return Value: None.
  */
-bool UNeuralNetworkModel::RunSync(UPARAM(ref) TArray<FNeuralNetworkTensor>& Outputs)
+void UNeuralNetworkModel::StopFramePipeline()
 {
-    UE_LOG(LogTemp, Warning, TEXT("RunSync called"));
+    check(IsInGameThread());
 
-    if (!Model.IsValid())
+    if (FramePipeline.IsValid())
+    {
+        FramePipeline->bStopped = true;
+        FramePipeline.Reset();
+    }
+}
+
+/*
+ - Parameters:
+    1) Pixels: Raw 8 bit pixels, 4 bytes per pixel, rows tightly packed.
+    2) Width, Height: Size of the image in pixels.
+    3) Format: Channel order of the pixels.
+ - What it does: Blueprint entry point of SubmitFrameImage.
+ - Return Value: bool indicating whether the frame was queued.
+ */
+bool UNeuralNetworkModel::SubmitFrame(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format)
+{
+    if (Width <= 0 || Height <= 0 || Pixels.Num() < Width * Height * 4)
     {
-        UE_LOG(LogTemp, Error, TEXT("RunSync failed: Model instance is invalid!"));
+        UE_LOG(LogNeuralNetwork, Error, TEXT("SubmitFrame failed: %d bytes is not a %dx%d image"), Pixels.Num(), Width, Height);
         return false;
     }
 
-    using namespace UE::NNE;
+    FNeuralNetworkImageView Image;
+    Image.Pixels = Pixels.GetData();
+    Image.Width = Width;
+    Image.Height = Height;
+    Image.RowStride = Width * 4;
+    Image.Format = Format;
+    return SubmitFrameImage(Image);
+}
 
-    TConstArrayView<FTensorDesc> OutputDescs = ModelInstance->GetOutputTensorDescs();
-    if (OutputDescs.Num() != Outputs.Num())
+/*
+ - Parameters:
+    1) Image: The captured frame.
+ - What it does: Letterboxes the frame straight into the queue's write slot and publishes it, replacing a queued frame
+   the worker has not picked up yet. Starts the worker if it is idle. Never waits for inference.
+ - Return Value: bool indicating whether the frame was queued.
+ */
+bool UNeuralNetworkModel::SubmitFrameImage(const FNeuralNetworkImageView& Image)
+{
+    TSharedPtr<FNeuralNetworkFramePipeline, ESPMode::ThreadSafe> Pipeline = FramePipeline;
+    if (!Pipeline.IsValid() || Pipeline->bStopped)
     {
-        UE_LOG(LogTemp, Error, TEXT("RunSync failed: Expected %d output tensors, but got %d"), OutputDescs.Num(), Outputs.Num());
+        UE_LOG(LogNeuralNetwork, Error, TEXT("SubmitFrame failed: StartFramePipeline has not been called"));
         return false;
     }
 
-    UE_LOG(LogTemp, Warning, TEXT("RunSync: Preparing output bindings..."));
-    
-    TArray<FTensorBindingCPU> OutputBindings;
-    OutputBindings.SetNum(Outputs.Num());
+    FNeuralNetworkFrame& Frame = Pipeline->Queue.GetWriteFrame();
+    if (!NeuralNetworkPreprocess::Letterbox(Image, Pipeline->InputWidth, Pipeline->InputHeight, Frame.Data.GetData(), Frame.Letterbox))
+    {
+        return false;
+    }
+    Frame.CaptureTime = FPlatformTime::Seconds();
+    Pipeline->Queue.Publish();
 
-    for (int32 i = 0; i < Outputs.Num(); i++)
+    if (!Pipeline->bWorkerActive.exchange(true))
     {
-        if (Outputs[i].Data.Num() == 0)
+        TWeakObjectPtr<UNeuralNetworkModel> WeakThis(this);
+        UE::Tasks::Launch(UE_SOURCE_LOCATION, [Pipeline, WeakThis]()
         {
-            UE_LOG(LogTemp, Error, TEXT("RunSync failed: Output tensor at index %d is empty"), i);
-            return false;
-        }
+            DrainFramePipeline(Pipeline, WeakThis);
+        });
+    }
 
-        OutputBindings[i].Data = (void*)Outputs[i].Data.GetData();
-        OutputBindings[i].SizeInBytes = Outputs[i].Data.Num() * sizeof(float);
+    return true;
+}
 
-        UE_LOG(LogTemp, Warning, TEXT("RunSync: Output Tensor %d -> Size: %d bytes"), i, OutputBindings[i].SizeInBytes);
-    }
+/*
+ - Parameters: None.
+ - What it does: Reports how many frames were submitted, dropped as stale and processed since StartFramePipeline.
+ - Return Value: FNeuralNetworkFrameQueueStats, all zero when the pipeline is not running.
+ */
+FNeuralNetworkFrameQueueStats UNeuralNetworkModel::GetFrameQueueStats() const
+{
+    return FramePipeline.IsValid() ? FramePipeline->Queue.GetStats() : FNeuralNetworkFrameQueueStats();
+}
 
-    UE_LOG(LogTemp, Warning, TEXT("RunSync: Running model synchronously..."));
+/*
+ - Parameters: None.
+ - What it does: Reports whether a RunAsync call has not broadcast its result yet.
+ - Return Value: bool, true while a run is pending.
+ */
+bool UNeuralNetworkModel::IsRunInFlight() const
+{
+    return bRunInFlight;
+}
 
-    EResultStatus RunStatus = ModelInstance->RunSync(InputBindings, OutputBindings);
-    if (RunStatus != UE::NNE::EResultStatus::Ok)
+/*
+ - Parameters: None.
+ - What it does: Cancels a pending RunAsync and stops the frame pipeline so their results are dropped instead of being
+   broadcast to a dying object.
+ - Return Value: None.
+ */
+void UNeuralNetworkModel::BeginDestroy()
+{
+    if (AsyncRun.IsValid())
     {
-        UE_LOG(LogTemp, Error, TEXT("RunSync failed: Model execution returned an error"));
-        return false;
+        AsyncRun->bCancelled = true;
     }
+    if (FramePipeline.IsValid())
+    {
+        FramePipeline->bStopped = true;
+    }
+    StopRecording();
 
-    UE_LOG(LogTemp, Warning, TEXT("RunSync: Model execution successful!"));
-    return true;
+    Super::BeginDestroy();
+}
+
+/*
+ - Parameters: None.
+ - What it does: Holds back destruction until the RunAsync and frame pipeline workers have returned.
+ - Return Value: bool, true once no worker is using this object's model instance.
+ */
+bool UNeuralNetworkModel::IsReadyForFinishDestroy()
+{
+    const bool bWorkerActive = (AsyncRun.IsValid() && AsyncRun->bWorkerActive)
+        || (FramePipeline.IsValid() && FramePipeline->bWorkerActive);
+    return Super::IsReadyForFinishDestroy() && !bWorkerActive;
 }
 
 
@@ -404,17 +3526,22 @@ bool UNeuralNetworkModel::RunSync(UPARAM(ref) TArray<FNeuralNetworkTensor>& Outp
 
 
 
-TArray<uint8> UNeuralNetworkModel::ProcessScreenshot()
+FString UNeuralNetworkModel::GetScreenshotPath()
 {
     FString ScreenshotFullPath = FPaths::ProjectSavedDir() / TEXT("Screenshots/MacEditor/HighresScreenshot00001.png");
-    UE_LOG(LogTemp, Warning, TEXT("Updated Screenshot Path: %s"), *ScreenshotFullPath);
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("Updated Screenshot Path: %s"), *ScreenshotFullPath);
+
+    return FPaths::ConvertRelativePathToFull(ScreenshotFullPath);
+}
 
-    FString AbsolutePath = FPaths::ConvertRelativePathToFull(ScreenshotFullPath);
-    UE_LOG(LogTemp, Warning, TEXT("ProcessScreenshot called with path: %s"), *AbsolutePath);
+TArray<uint8> UNeuralNetworkModel::ProcessScreenshot()
+{
+    FString AbsolutePath = GetScreenshotPath();
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("ProcessScreenshot called with path: %s"), *AbsolutePath);
 
     if (!FPaths::FileExists(AbsolutePath))
     {
-        UE_LOG(LogTemp, Error, TEXT("ProcessScreenshot: File does not exist at path: %s"), *AbsolutePath);
+        UE_LOG(LogNeuralNetwork, Error, TEXT("ProcessScreenshot: File does not exist at path: %s"), *AbsolutePath);
         return {};
     }
 
@@ -423,14 +3550,16 @@ TArray<uint8> UNeuralNetworkModel::ProcessScreenshot()
 
     if (PixelData.Num() == 0)
     {
-        UE_LOG(LogTemp, Error, TEXT("ProcessScreenshot: Failed to process screenshot at path: %s"), *AbsolutePath);
+        UE_LOG(LogNeuralNetwork, Error, TEXT("ProcessScreenshot: Failed to process screenshot at path: %s"), *AbsolutePath);
     }
     else
     {
-        UE_LOG(LogTemp, Warning, TEXT("ProcessScreenshot: Successfully loaded screenshot with size: %dx%d"), Width, Height);
+        UE_LOG(LogNeuralNetwork, Verbose, TEXT("ProcessScreenshot: Successfully loaded screenshot with size: %dx%d"), Width, Height);
     }
     
     // ✅ Print RGB values of the first 5 pixels
+    if (UE_LOG_ACTIVE(LogNeuralNetwork, VeryVerbose))
+    {
         int32 NumPixelsToPrint = 5;
         for (int32 i = 0; i < NumPixelsToPrint; i++)
         {
@@ -442,9 +3571,10 @@ TArray<uint8> UNeuralNetworkModel::ProcessScreenshot()
                 uint8 B = PixelData[Index + 2];
                 uint8 A = PixelData[Index + 3];
 
-                UE_LOG(LogTemp, Warning, TEXT("Pixel %d - R: %d, G: %d, B: %d, A: %d"), i, R, G, B, A);
+                UE_LOG(LogNeuralNetwork, VeryVerbose, TEXT("Pixel %d - R: %d, G: %d, B: %d, A: %d"), i, R, G, B, A);
             }
         }
+    }
 
     return PixelData;
 }
@@ -452,23 +3582,23 @@ TArray<uint8> UNeuralNetworkModel::ProcessScreenshot()
 
 TArray<uint8> UNeuralNetworkModel::LoadPNGToPixelArray(const FString& FilePath, int32& OutWidth, int32& OutHeight)
 {
-    UE_LOG(LogTemp, Warning, TEXT("LoadPNGToPixelArray called with path: %s"), *FilePath);
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("LoadPNGToPixelArray called with path: %s"), *FilePath);
 
     // Check if file exists before trying to load it
     if (!FPaths::FileExists(FilePath))
     {
-        UE_LOG(LogTemp, Error, TEXT("LoadPNGToPixelArray: File does not exist at path: %s"), *FilePath);
+        UE_LOG(LogNeuralNetwork, Error, TEXT("LoadPNGToPixelArray: File does not exist at path: %s"), *FilePath);
         return {};
     }
 
     TArray<uint8> RawFileData;
     if (!FFileHelper::LoadFileToArray(RawFileData, *FilePath))
     {
-        UE_LOG(LogTemp, Error, TEXT("LoadPNGToPixelArray: Failed to load PNG file: %s"), *FilePath);
+        UE_LOG(LogNeuralNetwork, Error, TEXT("LoadPNGToPixelArray: Failed to load PNG file: %s"), *FilePath);
         return {};
     }
 
-    UE_LOG(LogTemp, Warning, TEXT("LoadPNGToPixelArray: Successfully loaded file. Data size: %d bytes"), RawFileData.Num());
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("LoadPNGToPixelArray: Successfully loaded file. Data size: %d bytes"), RawFileData.Num());
 
     // Load the image wrapper module
     IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
@@ -476,30 +3606,30 @@ TArray<uint8> UNeuralNetworkModel::LoadPNGToPixelArray(const FString& FilePath,
 
     if (!ImageWrapper.IsValid())
     {
-        UE_LOG(LogTemp, Error, TEXT("LoadPNGToPixelArray: Failed to create ImageWrapper"));
+        UE_LOG(LogNeuralNetwork, Error, TEXT("LoadPNGToPixelArray: Failed to create ImageWrapper"));
         return {};
     }
 
     if (!ImageWrapper->SetCompressed(RawFileData.GetData(), RawFileData.Num()))
     {
-        UE_LOG(LogTemp, Error, TEXT("LoadPNGToPixelArray: Failed to set compressed data for PNG file: %s"), *FilePath);
+        UE_LOG(LogNeuralNetwork, Error, TEXT("LoadPNGToPixelArray: Failed to set compressed data for PNG file: %s"), *FilePath);
         return {};
     }
 
     OutWidth = ImageWrapper->GetWidth();
     OutHeight = ImageWrapper->GetHeight();
 
-    UE_LOG(LogTemp, Warning, TEXT("LoadPNGToPixelArray: Image dimensions: %dx%d"), OutWidth, OutHeight);
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("LoadPNGToPixelArray: Image dimensions: %dx%d"), OutWidth, OutHeight);
 
     // Extract raw pixel data
     TArray<uint8> RawData;
     if (!ImageWrapper->GetRaw(ERGBFormat::RGBA, 8, RawData))
     {
-        UE_LOG(LogTemp, Error, TEXT("LoadPNGToPixelArray: Failed to extract raw pixel data from: %s"), *FilePath);
+        UE_LOG(LogNeuralNetwork, Error, TEXT("LoadPNGToPixelArray: Failed to extract raw pixel data from: %s"), *FilePath);
         return {};
     }
 
-    UE_LOG(LogTemp, Warning, TEXT("LoadPNGToPixelArray: Successfully extracted %d bytes of pixel data"), RawData.Num());
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("LoadPNGToPixelArray: Successfully extracted %d bytes of pixel data"), RawData.Num());
     
     return RawData;
 }
@@ -12,6 +12,24 @@
 #include "NNEModelData.h"
 #include "Engine/TextureRenderTarget2D.h"
 
+#include "NeuralNetworkCascade.h"
+#include "NeuralNetworkChangeGate.h"
+#include "NeuralNetworkDetection.h"
+#include "NeuralNetworkFoveation.h"
+#include "NeuralNetworkFrameQueue.h"
+#include "NeuralNetworkImageSequence.h"
+#include "NeuralNetworkInstancePool.h"
+#include "NeuralNetworkModelCache.h"
+#include "NeuralNetworkPreprocess.h"
+#include "NeuralNetworkRecording.h"
+#include "NeuralNetworkResolutionController.h"
+#include "NeuralNetworkRuntimeSelection.h"
+#include "NeuralNetworkStereo.h"
+#include "NeuralNetworkTensorHandle.h"
+#include "NeuralNetworkTensorPool.h"
+#include "NeuralNetworkTiling.h"
+#include "NeuralNetworkTracker.h"
+
 #include "NeuralNetworkModel.generated.h"
 
 
@@ -35,6 +53,26 @@ public:
     TArray<float> Data = TArray<float>();
 };
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnNeuralNetworkModelReady, bool, bSuccess);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnNeuralNetworkRunCompleted, bool, bSuccess, const TArray<FNeuralNetworkTensor>&, Outputs);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnNeuralNetworkFrameProcessed, int64, FrameNumber, bool, bSuccess, const TArray<FNeuralNetworkDetection>&, Detections);
+
+// A model instance kept prepared for one set of concrete input shapes
+struct FNeuralNetworkPreparedInstance
+{
+    TSharedPtr<UE::NNE::IModelInstanceCPU> Instance;
+    TArray<UE::NNE::FTensorShape> Shapes;
+    uint64 LastUsed = 0;
+};
+
+// Worker side state of RunAsync, defined in NeuralNetworkModel.cpp
+struct FNeuralNetworkAsyncRun;
+
+// Frame queue and worker state of SubmitFrame, defined in NeuralNetworkModel.cpp
+struct FNeuralNetworkFramePipeline;
+
 UCLASS(BlueprintType, Category = "NNE - Tutorial")
 class TUTORIAL_API UNeuralNetworkModel : public UObject
 {
@@ -48,11 +86,48 @@ public:
     UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
     static UNeuralNetworkModel* CreateModel(UObject* Parent, FString RuntimeName, UNNEModelData* ModelData);
 
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    static UNeuralNetworkModel* CreateModelAsync(UObject* Parent, FString RuntimeName, UNNEModelData* ModelData, int32 NumWarmupRuns = 1);
+
+    // Runtime picked by the last CreateModel / CreateModelAsync call with RuntimeName "Auto", and the timings behind it
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    static FNeuralNetworkRuntimeSelection GetRuntimeSelection();
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    static FNeuralNetworkModelCacheStats GetModelCacheStats();
+
+    // Prepares the instance for its default input shapes and runs it NumRuns times. OutMeanMilliseconds receives the
+    // mean time of the runs after the first one. Safe to call from any thread.
+    static bool WarmUpInstance(UE::NNE::IModelInstanceCPU& Instance, int32 NumRuns, TArray<UE::NNE::FTensorShape>& OutShapes, double* OutMeanMilliseconds = nullptr);
+
     UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
     static bool CreateTensor(TArray<int32> Shape, UPARAM(ref) FNeuralNetworkTensor& Tensor);
 
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    static bool DecodeDetections(const FNeuralNetworkTensor& Output, const FNeuralNetworkLetterbox& Letterbox, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    static bool PreprocessPixels(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format, UPARAM(ref) FNeuralNetworkTensor& Tensor, FNeuralNetworkLetterbox& Letterbox);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    static bool PreprocessColors(const TArray<FColor>& Colors, int32 Width, int32 Height, UPARAM(ref) FNeuralNetworkTensor& Tensor, FNeuralNetworkLetterbox& Letterbox);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool PreprocessRenderTarget(UTextureRenderTarget2D* RenderTarget, UPARAM(ref) FNeuralNetworkTensor& Tensor, FNeuralNetworkLetterbox& Letterbox);
+
+    // Raw pointer + stride entry point, e.g. for a mapped GPU readback or a camera SDK buffer
+    static bool PreprocessImage(const FNeuralNetworkImageView& Image, FNeuralNetworkTensor& Tensor, FNeuralNetworkLetterbox& Letterbox);
+
 public:
 
+    // False while CreateModelAsync is still building the model, nothing else may be called until OnModelReady
+    UFUNCTION(BlueprintPure, Category = "NNE - Tutorial")
+    bool IsReady() const;
+
+    // Fired on the game thread once CreateModelAsync has finished, successfully or not
+    UPROPERTY(BlueprintAssignable, Category = "NNE - Tutorial")
+    FOnNeuralNetworkModelReady OnModelReady;
+
     UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
     int32 NumInputs();
 
@@ -65,6 +140,77 @@ public:
     UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
     TArray<int32> GetOutputShape(int32 Index);
 
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    void SetShapeCacheSize(int32 CacheSize);
+
+    // Like CreateTensor, but the storage comes from this model's tensor pool. Hand it back with ReleaseTensor once
+    // the tensor is no longer needed, e.g. at the end of the frame, so the next AcquireTensor reuses it.
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool AcquireTensor(TArray<int32> Shape, UPARAM(ref) FNeuralNetworkTensor& Tensor);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    void ReleaseTensor(UPARAM(ref) FNeuralNetworkTensor& Tensor);
+
+    // Replaces the tensor pool, buffers still in use go back to the old pool and are freed there
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    void ConfigureTensorPool(const FNeuralNetworkTensorPoolSettings& Settings);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    void TrimTensorPool();
+
+    UFUNCTION(BlueprintPure, Category = "NNE - Tutorial")
+    FNeuralNetworkTensorPoolStats GetTensorPoolStats() const;
+
+    // For native callers that want 64 byte aligned buffers, safe to use from any thread
+    TSharedPtr<FNeuralNetworkTensorPool, ESPMode::ThreadSafe> GetTensorPool();
+
+public:
+
+    // Handle based path: frames and tensors stay in native memory from capture to decode, Blueprint only passes IDs.
+    // Every handle has to be released once it is no longer needed.
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    FNeuralNetworkTensorHandle CreateTensorHandle(TArray<int32> Shape);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    static void ReleaseTensorHandle(UPARAM(ref) FNeuralNetworkTensorHandle& Handle);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    static void ReleaseImageHandle(UPARAM(ref) FNeuralNetworkImageHandle& Handle);
+
+    UFUNCTION(BlueprintPure, Category = "NNE - Tutorial")
+    static TArray<int32> GetTensorHandleShape(const FNeuralNetworkTensorHandle& Handle);
+
+    // The one explicit copy, for inspecting a tensor in Blueprint
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    static bool CopyTensorHandle(const FNeuralNetworkTensorHandle& Handle, FNeuralNetworkTensor& Tensor);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    FNeuralNetworkImageHandle LoadPNGToImageHandle(const FString& FilePath);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    FNeuralNetworkImageHandle ProcessScreenshotHandle();
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    static FNeuralNetworkImageHandle ReadRenderTargetHandle(UTextureRenderTarget2D* RenderTarget);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool PreprocessImageHandle(const FNeuralNetworkImageHandle& Image, UPARAM(ref) FNeuralNetworkTensorHandle& Tensor, FNeuralNetworkLetterbox& Letterbox);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool SetInputHandles(const TArray<FNeuralNetworkTensorHandle>& Inputs);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool RunSyncHandles(UPARAM(ref) TArray<FNeuralNetworkTensorHandle>& Outputs);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    static bool DecodeDetectionsHandle(const FNeuralNetworkTensorHandle& Output, const FNeuralNetworkLetterbox& Letterbox, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool DetectImageHandle(const FNeuralNetworkImageHandle& Image, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections);
+
+    static TArray<int32> ResolveSymbolicShape(TConstArrayView<int32> SymbolicShape, const TArray<int32>& Fallback);
+
 public:
 
     UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
@@ -72,6 +218,181 @@ public:
 
     UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
     bool RunSync(UPARAM(ref) TArray<FNeuralNetworkTensor>& Outputs);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool PrepareSession(const TArray<FNeuralNetworkTensor>& Inputs, UPARAM(ref) TArray<FNeuralNetworkTensor>& Outputs);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool RunPrepared();
+
+    // Native side of PrepareSession, the memory must stay valid until it is rebound
+    bool BindInput(int32 Index, const float* Data, int32 NumElements, TConstArrayView<int32> Shape);
+    bool BindOutput(int32 Index, float* Data, int32 NumElements);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool RunAsync(const TArray<FNeuralNetworkTensor>& Outputs);
+
+    UFUNCTION(BlueprintPure, Category = "NNE - Tutorial")
+    bool IsRunInFlight() const;
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool RunBatch(const TArray<FNeuralNetworkTensor>& Frames, UPARAM(ref) TArray<FNeuralNetworkTensor>& FrameOutputs);
+
+    // Runs an already packed NxCxHxW input. FrameOutputs receives NumOutputs() tensors per frame, frame major.
+    bool RunBatched(TConstArrayView<float> PackedInput, TConstArrayView<int32> BatchShape, TArray<FNeuralNetworkTensor>& FrameOutputs);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool CreateInstancePool(int32 PoolSize);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool RunPooled(const TArray<FNeuralNetworkTensor>& Inputs, UPARAM(ref) TArray<FNeuralNetworkTensor>& Outputs, int32 WaitMilliseconds);
+
+    // For native callers that check out instances themselves, safe to use from any thread
+    TSharedPtr<FNeuralNetworkInstancePool, ESPMode::ThreadSafe> GetInstancePool() const { return InstancePool; }
+
+    // Fired on the game thread when a RunAsync call finishes
+    UPROPERTY(BlueprintAssignable, Category = "NNE - Tutorial")
+    FOnNeuralNetworkRunCompleted OnRunCompleted;
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool StartFramePipeline(const FNeuralNetworkDecodeSettings& Settings);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    void StopFramePipeline();
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool SubmitFrame(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format);
+
+    // Native side of SubmitFrame, must be called from one producer thread at a time
+    bool SubmitFrameImage(const FNeuralNetworkImageView& Image);
+
+    UFUNCTION(BlueprintPure, Category = "NNE - Tutorial")
+    FNeuralNetworkFrameQueueStats GetFrameQueueStats() const;
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool Detect(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections);
+
+    // Native side of Detect
+    bool DetectImage(const FNeuralNetworkImageView& Image, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool DetectStereo(const TArray<uint8>& LeftPixels, const TArray<uint8>& RightPixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format,
+        const FNeuralNetworkDecodeSettings& Settings, const FNeuralNetworkStereoSettings& StereoSettings, TArray<FNeuralNetworkDetection>& Detections);
+
+    // Native side of DetectStereo
+    bool DetectStereoImages(const FNeuralNetworkImageView& Left, const FNeuralNetworkImageView& Right, const FNeuralNetworkDecodeSettings& Settings,
+        const FNeuralNetworkStereoSettings& StereoSettings, TArray<FNeuralNetworkDetection>& Detections);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool DetectTiled(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format,
+        const FNeuralNetworkDecodeSettings& Settings, const FNeuralNetworkTilingSettings& TilingSettings, TArray<FNeuralNetworkDetection>& Detections);
+
+    // Native side of DetectTiled
+    bool DetectTiledImage(const FNeuralNetworkImageView& Image, const FNeuralNetworkDecodeSettings& Settings,
+        const FNeuralNetworkTilingSettings& TilingSettings, TArray<FNeuralNetworkDetection>& Detections);
+
+    // Offline: runs every frame of an image sequence through batched inference in order, streaming the detections to
+    // SequenceSettings.OutputPath. Blocks until the sequence is done, game thread only.
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool DetectImageSequence(const FNeuralNetworkImageSequenceSettings& SequenceSettings, const FNeuralNetworkDecodeSettings& Settings, FNeuralNetworkImageSequenceStats& Stats);
+
+    // Second stage of DetectCascade, created from ClassifierData with a 1x3xHxW (ideally dynamic batch) input and a
+    // NxClasses output. nullptr removes the classifier.
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool SetClassifier(FString RuntimeName, UNNEModelData* ClassifierData);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool DetectCascade(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format,
+        const FNeuralNetworkDecodeSettings& Settings, const FNeuralNetworkCascadeSettings& CascadeSettings, TArray<FNeuralNetworkDetection>& Detections);
+
+    // Native side of DetectCascade
+    bool DetectCascadeImage(const FNeuralNetworkImageView& Image, const FNeuralNetworkDecodeSettings& Settings,
+        const FNeuralNetworkCascadeSettings& CascadeSettings, TArray<FNeuralNetworkDetection>& Detections);
+
+    // Runs only the second stage on detections of Image from any source, e.g. DetectTrackedImage
+    bool ClassifyDetections(const FNeuralNetworkImageView& Image, const FNeuralNetworkCascadeSettings& CascadeSettings, TArray<FNeuralNetworkDetection>& Detections);
+
+    // Detect with tracking: the network only runs at the tracker's cadence, boxes are predicted for the frames in
+    // between and carry a stable TrackId. Plain Detect until EnableTracking is called.
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool DetectTracked(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format,
+        const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections);
+
+    // Native side of DetectTracked
+    bool DetectTrackedImage(const FNeuralNetworkImageView& Image, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    void EnableTracking(const FNeuralNetworkTrackerSettings& Settings);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    void DisableTracking();
+
+    UFUNCTION(BlueprintPure, Category = "NNE - Tutorial")
+    FNeuralNetworkTrackerStats GetTrackerStats() const;
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool DetectFoveated(const TArray<uint8>& Pixels, int32 Width, int32 Height, ENeuralNetworkPixelFormat Format,
+        const FNeuralNetworkDecodeSettings& Settings, const FNeuralNetworkFoveationSettings& FoveationSettings, TArray<FNeuralNetworkDetection>& Detections);
+
+    // Native side of DetectFoveated
+    bool DetectFoveatedImage(const FNeuralNetworkImageView& Image, const FNeuralNetworkDecodeSettings& Settings,
+        const FNeuralNetworkFoveationSettings& FoveationSettings, TArray<FNeuralNetworkDetection>& Detections);
+
+    // Gaze point for DetectFoveated, normalized over the frame with (0, 0) at the top left
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    void SetGazePoint(FVector2D Gaze);
+
+    // View direction in the capture camera's space, e.g. the HMD forward vector relative to the camera
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    void SetGazeDirection(FVector Direction, float HorizontalFovDegrees);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool LoadGazeTrace(const FString& FilePath);
+
+    // Any other gaze provider, nullptr falls back to the frame center
+    void SetGazeSource(TSharedPtr<INeuralNetworkGazeSource> Source) { GazeSource = MoveTemp(Source); }
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool EnableAdaptiveResolution(const FNeuralNetworkResolutionSettings& Settings);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    void DisableAdaptiveResolution();
+
+    UFUNCTION(BlueprintPure, Category = "NNE - Tutorial")
+    FNeuralNetworkResolutionStats GetResolutionStats() const;
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    void EnableChangeGate(const FNeuralNetworkChangeGateSettings& Settings);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    void DisableChangeGate();
+
+    UFUNCTION(BlueprintPure, Category = "NNE - Tutorial")
+    FNeuralNetworkChangeGateStats GetChangeGateStats() const;
+
+    // Records every frame given to Detect from now on. The file is created with the size of the first frame, frames of
+    // another size are skipped. Tensor recordings replay without preprocessing.
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    void StartRecording(const FString& FilePath, ENeuralNetworkRecordingFormat Format, bool bCompress);
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool StopRecording();
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool OpenRecording(const FString& FilePath);
+
+    UFUNCTION(BlueprintPure, Category = "NNE - Tutorial")
+    int32 GetRecordingFrameCount() const;
+
+    UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
+    bool DetectRecordedFrame(int32 FrameIndex, const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections);
+
+    // The recording opened by OpenRecording, for native callers that read frames themselves
+    const FNeuralNetworkRecordingReader* GetRecording() const { return Replay.Get(); }
+
+    // Fired on the game thread for every frame the pipeline worker ran, frames dropped as stale never show up here
+    UPROPERTY(BlueprintAssignable, Category = "NNE - Tutorial")
+    FOnNeuralNetworkFrameProcessed OnFrameProcessed;
     
     //UFUNCTION(BlueprintCallable, Category = "NNE - Tutorial")
     //bool ConvertPngToTensorInput(const FString& PngFilePath);
@@ -86,12 +407,102 @@ public:
     TArray<uint8> LoadPNGToPixelArray(const FString& FilePath, int32& OutWidth, int32& OutHeight);
 
 
+public:
+
+    virtual void BeginDestroy() override;
+    virtual bool IsReadyForFinishDestroy() override;
+
 private:
+    static FString SelectRuntimeName(const FString& RequestedRuntimeName, UNNEModelData* ModelData, TSharedPtr<UE::NNE::IModelCPU>& OutSelectedModel);
+    static FString GetScreenshotPath();
+    static bool DecodeOutput(TConstArrayView<int32> Shape, TConstArrayView<float> Data, const FNeuralNetworkLetterbox& Letterbox,
+        const FNeuralNetworkDecodeSettings& Settings, TArray<FNeuralNetworkDetection>& Detections);
+
     TSharedPtr<UE::NNE::IModelCPU> Model;
     TSharedPtr<UE::NNE::IModelInstanceCPU> ModelInstance;
     TArray<UE::NNE::FTensorBindingCPU> InputBindings;
+    TArray<UE::NNE::FTensorBindingCPU> OutputBindings;
+
+    // Shapes of the bound inputs, and the shapes ModelInstance is currently prepared for
+    TArray<UE::NNE::FTensorShape> BoundInputShapes;
     TArray<UE::NNE::FTensorShape> InputShapes;
 
+    bool ApplyInputShapes(TConstArrayView<UE::NNE::FTensorShape> Shapes);
+    bool RunDetectInput(TConstArrayView<float> Input, TConstArrayView<int32> InputShape);
+    bool RunDetectFrame(const FNeuralNetworkImageView& Image, FNeuralNetworkLetterbox& OutLetterbox);
+    TArray<int32> GetImageInputShape();
+    void RecordFrame(const FNeuralNetworkImageView& Image, const FNeuralNetworkLetterbox* Letterbox);
+
+    // Instances prepared for other input shapes than ModelInstance, so switching resolution back and forth is cheap
+    TArray<FNeuralNetworkPreparedInstance> PreparedInstances;
+    int32 MaxPreparedInstances = 3;
+    uint64 PreparedInstanceUseCount = 0;
+
+    // Backs AcquireTensor and the staging buffers below, created on first use
+    TSharedPtr<FNeuralNetworkTensorPool, ESPMode::ThreadSafe> TensorPool;
+
+    // Staging memory of RunBatch / RunBatched, kept between calls
+    FNeuralNetworkTensorPool::FBuffer BatchInput;
+    TArray<FNeuralNetworkTensorPool::FBuffer> BatchOutputs;
+
+    // Extra instances of Model for concurrent callers, independent of ModelInstance
+    TSharedPtr<FNeuralNetworkInstancePool, ESPMode::ThreadSafe> InstancePool;
+
+    // Owned copies of the inputs and outputs of the pending RunAsync, reused between runs
+    TSharedPtr<FNeuralNetworkAsyncRun, ESPMode::ThreadSafe> AsyncRun;
+
+    // True from RunAsync until OnRunCompleted has been broadcast, only touched on the game thread
+    bool bRunInFlight = false;
+
+    // Readback of PreprocessRenderTarget, kept so a steady capture does not reallocate it every frame
+    TArray<FColor> ReadbackPixels;
+
+    // Staging memory of Detect, and its last result returned again for frames the change gate skips
+    FNeuralNetworkTensor DetectInput;
+    TArray<FNeuralNetworkTensor> DetectOutputs;
+    TArray<UE::NNE::FTensorBindingCPU> DetectOutputBindings;
+    TArray<FNeuralNetworkDetection> LastDetections;
+    TUniquePtr<FNeuralNetworkChangeGate> ChangeGate;
+    TUniquePtr<FNeuralNetworkResolutionController> ResolutionController;
+    TUniquePtr<FNeuralNetworkTracker> Tracker;
+    TArray<FNeuralNetworkDetection> TrackerInput;
+
+    // DetectCascade state, the classifier is a model of its own with its own instance and staging memory
+    UPROPERTY()
+    TObjectPtr<UNeuralNetworkModel> Classifier;
+    bool bClassifierBatching = true;
+    TArray<int32> CascadeCrops;
+    FNeuralNetworkTensorPool::FBuffer CascadeInput;
+    TArray<FNeuralNetworkTensor> CascadeOutputs;
+
+    // StartRecording / OpenRecording state, the writer is opened on the first recorded frame
+    TUniquePtr<FNeuralNetworkRecordingWriter> Recorder;
+    FString RecordingPath;
+    ENeuralNetworkRecordingFormat RecordingFormat = ENeuralNetworkRecordingFormat::Pixels;
+    bool bCompressRecording = false;
+    TUniquePtr<FNeuralNetworkRecordingReader> Replay;
+    TArray<uint8> ReplayScratch;
+
+    // Staging memory of DetectStereo
+    FNeuralNetworkTensorPool::FBuffer StereoInput;
+    TArray<float> StereoScratch[2];
+    TArray<FNeuralNetworkTensor> StereoOutputs;
+
+    // DetectFoveated state, the full frame detections are reused between full frame passes
+    TSharedPtr<INeuralNetworkGazeSource> GazeSource;
+    TArray<FNeuralNetworkDetection> FullFrameDetections;
+    FIntPoint FullFrameSize = FIntPoint::ZeroValue;
+    uint64 FoveatedFrameNumber = 0;
+
+    // Staging memory of DetectTiled
+    TArray<FIntRect> Tiles;
+    FNeuralNetworkTensorPool::FBuffer TileInput;
+    TArray<FNeuralNetworkLetterbox> TileLetterboxes;
+    TArray<FNeuralNetworkTensor> TileOutputs;
+
+    // Latest-frame-wins queue feeding its own model instance on a worker task, independent of ModelInstance
+    TSharedPtr<FNeuralNetworkFramePipeline, ESPMode::ThreadSafe> FramePipeline;
+
 };
 
 
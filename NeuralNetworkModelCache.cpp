@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkModelCache.h"
+#include "NeuralNetworkStats.h"
+
+#include "Misc/ScopeLock.h"
+
+// ######################################################################################################################
+
+FNeuralNetworkModelCache& FNeuralNetworkModelCache::Get()
+{
+    static FNeuralNetworkModelCache Instance;
+    return Instance;
+}
+
+/*
+- Parameters:
+ 1) ModelData: The model asset.
+ 2) RuntimeName: The CPU runtime to create the model on.
+- What it does: Returns a handle to the model already created for this asset and runtime, or creates and caches it.
+  The weights and the optimized graph live in the shared model, callers only create their own lightweight instances.
+- Return Value: The model handle, or nullptr if the runtime is missing or the model could not be created.
+*/
+TSharedPtr<UE::NNE::IModelCPU> FNeuralNetworkModelCache::FindOrCreate(UNNEModelData* ModelData, const FString& RuntimeName)
+{
+    using namespace UE::NNE;
+
+    if (!ModelData)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("FNeuralNetworkModelCache: ModelData is null"));
+        return nullptr;
+    }
+
+    const FString Key = ModelData->GetPathName() + TEXT("|") + RuntimeName;
+
+    FScopeLock ScopeLock(&Lock);
+    RemoveExpiredEntries();
+
+    if (FEntry* Entry = Entries.Find(Key))
+    {
+        if (TSharedPtr<IModelCPU> Shared = Entry->Model.Pin())
+        {
+            Hits++;
+            UE_LOG(LogNeuralNetwork, Log, TEXT("FNeuralNetworkModelCache: Reusing %s on %s (%d users)"), *ModelData->GetName(), *RuntimeName, Entry->Users->load() + 1);
+            return MakeHandle(Shared, Entry->Users);
+        }
+    }
+
+    TWeakInterfacePtr<INNERuntimeCPU> Runtime = GetRuntime<INNERuntimeCPU>(RuntimeName);
+    if (!Runtime.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("No CPU runtime '%s' found"), *RuntimeName);
+        return nullptr;
+    }
+
+    TSharedPtr<IModelCPU> Model = Runtime->CreateModelCPU(ModelData);
+    if (!Model.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Could not create the CPU model"));
+        return nullptr;
+    }
+
+    Misses++;
+
+    FEntry& Entry = Entries.Add(Key);
+    Entry.Model = Model;
+    Entry.Users = MakeShared<std::atomic<int32>, ESPMode::ThreadSafe>(0);
+    Entry.ModelBytes = ModelData->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+
+    UE_LOG(LogNeuralNetwork, Log, TEXT("FNeuralNetworkModelCache: Created %s on %s (~%lld bytes)"), *ModelData->GetName(), *RuntimeName, Entry.ModelBytes);
+    return MakeHandle(Model, Entry.Users);
+}
+
+/*
+- Parameters: None.
+- What it does: Collects the hit / miss counters and estimates the memory saved by sharing.
+- Return Value: FNeuralNetworkModelCacheStats snapshot.
+*/
+FNeuralNetworkModelCacheStats FNeuralNetworkModelCache::GetStats()
+{
+    FScopeLock ScopeLock(&Lock);
+    RemoveExpiredEntries();
+
+    FNeuralNetworkModelCacheStats Stats;
+    Stats.Hits = Hits;
+    Stats.Misses = Misses;
+    Stats.CachedModels = Entries.Num();
+    for (const TPair<FString, FEntry>& Pair : Entries)
+    {
+        const int32 Users = Pair.Value.Users->load();
+        Stats.Users += Users;
+        Stats.EstimatedBytesSaved += FMath::Max(0, Users - 1) * Pair.Value.ModelBytes;
+    }
+    return Stats;
+}
+
+/*
+- Parameters:
+ 1) Model: The shared model.
+ 2) Users: The user counter of its cache entry.
+- What it does: Wraps the model in a per caller handle. The handle keeps the model alive and decrements the user count
+  when the caller releases it, so the last release destroys the model and expires the entry. Handles can be created
+  and released on any thread.
+- Return Value: The handle.
+*/
+TSharedPtr<UE::NNE::IModelCPU> FNeuralNetworkModelCache::MakeHandle(const TSharedPtr<UE::NNE::IModelCPU>& Model, const TSharedPtr<std::atomic<int32>, ESPMode::ThreadSafe>& Users)
+{
+    Users->fetch_add(1);
+    return MakeShareable(Model.Get(), [Model, Users](UE::NNE::IModelCPU*) mutable
+    {
+        // The model's own reference count is not thread safe, releases are serialized with FindOrCreate
+        FScopeLock ScopeLock(&FNeuralNetworkModelCache::Get().Lock);
+        Users->fetch_sub(1);
+        Model.Reset();
+    });
+}
+
+void FNeuralNetworkModelCache::RemoveExpiredEntries()
+{
+    for (auto It = Entries.CreateIterator(); It; ++It)
+    {
+        if (!It.Value().Model.IsValid())
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NNE.h"
+#include "NNERuntimeCPU.h"
+#include "NNEModelData.h"
+
+#include <atomic>
+
+#include "NeuralNetworkModelCache.generated.h"
+
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkModelCacheStats
+{
+    GENERATED_BODY()
+
+public:
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 Hits = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 Misses = 0;
+
+    // Models currently alive in the cache
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 CachedModels = 0;
+
+    // Callers currently holding one of the cached models
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 Users = 0;
+
+    // Estimated model memory not duplicated thanks to sharing, summed over the cached models
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 EstimatedBytesSaved = 0;
+};
+
+// Process wide cache of CPU models keyed by (model asset, runtime name). Every caller gets its own handle to the shared
+// IModelCPU; when the last handle is released the model is destroyed and its entry evicted.
+class TUTORIAL_API FNeuralNetworkModelCache
+{
+public:
+
+    static FNeuralNetworkModelCache& Get();
+
+    TSharedPtr<UE::NNE::IModelCPU> FindOrCreate(UNNEModelData* ModelData, const FString& RuntimeName);
+
+    FNeuralNetworkModelCacheStats GetStats();
+
+private:
+
+    struct FEntry
+    {
+        TWeakPtr<UE::NNE::IModelCPU> Model;
+        TSharedPtr<std::atomic<int32>, ESPMode::ThreadSafe> Users;
+        int64 ModelBytes = 0;
+    };
+
+    static TSharedPtr<UE::NNE::IModelCPU> MakeHandle(const TSharedPtr<UE::NNE::IModelCPU>& Model, const TSharedPtr<std::atomic<int32>, ESPMode::ThreadSafe>& Users);
+
+    void RemoveExpiredEntries();
+
+    FCriticalSection Lock;
+    TMap<FString, FEntry> Entries;
+    int32 Hits = 0;
+    int32 Misses = 0;
+};
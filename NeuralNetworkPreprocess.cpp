@@ -0,0 +1,292 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkPreprocess.h"
+#include "NeuralNetworkStats.h"
+
+#include "Async/ParallelFor.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+    #include <arm_neon.h>
+    #define NN_PREPROCESS_NEON 1
+#else
+    #define NN_PREPROCESS_NEON 0
+#endif
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+    #include <emmintrin.h>
+    #define NN_PREPROCESS_SSE 1
+#else
+    #define NN_PREPROCESS_SSE 0
+#endif
+
+#if NN_PREPROCESS_SSE && PLATFORM_ALWAYS_HAS_AVX_2
+    #include <immintrin.h>
+    #define NN_PREPROCESS_AVX2 1
+#else
+    #define NN_PREPROCESS_AVX2 0
+#endif
+
+namespace NeuralNetworkPreprocess
+{
+    static constexpr float InvByte = 1.0f / 255.0f;
+
+    // Rows per ParallelFor task, a 640 wide row is far too small to be worth a task on its own
+    static constexpr int32 RowsPerTask = 32;
+
+    // Byte offsets of the nearest source pixel for every column of the scaled (unpadded) region
+    using FColumnOffsets = TArray<int32, TInlineAllocator<2048>>;
+
+    static bool ValidateArguments(const FNeuralNetworkImageView& Image, int32 TargetWidth, int32 TargetHeight, const float* OutTensor)
+    {
+        if (!Image.Pixels || Image.Width < 1 || Image.Height < 1 || Image.RowStride < Image.Width * 4)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Letterbox failed: Invalid source image (%dx%d, stride %d)"), Image.Width, Image.Height, Image.RowStride);
+            return false;
+        }
+
+        if (!OutTensor || TargetWidth < 1 || TargetHeight < 1)
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("Letterbox failed: Invalid target tensor (%dx%d)"), TargetWidth, TargetHeight);
+            return false;
+        }
+
+        return true;
+    }
+
+    // Everything the row kernel needs, computed once per call
+    struct FLetterboxPlan
+    {
+        FNeuralNetworkLetterbox Box;
+        int32 ScaledWidth = 0;
+        int32 ScaledHeight = 0;
+        FColumnOffsets Offsets;
+    };
+
+    static void BuildPlan(const FNeuralNetworkImageView& Image, int32 TargetWidth, int32 TargetHeight, FLetterboxPlan& OutPlan)
+    {
+        OutPlan.Box = ComputeLetterbox(Image.Width, Image.Height, TargetWidth, TargetHeight);
+        OutPlan.ScaledWidth = FMath::Clamp(FMath::RoundToInt(Image.Width * OutPlan.Box.Scale), 1, TargetWidth);
+        OutPlan.ScaledHeight = FMath::Clamp(FMath::RoundToInt(Image.Height * OutPlan.Box.Scale), 1, TargetHeight);
+
+        OutPlan.Offsets.SetNumUninitialized(OutPlan.ScaledWidth);
+        for (int32 X = 0; X < OutPlan.ScaledWidth; X++)
+        {
+            const int32 SourceX = FMath::Min(static_cast<int32>((X + 0.5f) / OutPlan.Box.Scale), Image.Width - 1);
+            OutPlan.Offsets[X] = SourceX * 4;
+        }
+    }
+
+    static FORCEINLINE void FillPlanes(float* R, float* G, float* B, int32 Count)
+    {
+        for (int32 X = 0; X < Count; X++)
+        {
+            R[X] = PadValue;
+            G[X] = PadValue;
+            B[X] = PadValue;
+        }
+    }
+
+    // Deinterleaves the sampled pixels of one row into the three planes. Channel 0 of the pixel goes to C0, etc.
+    static void ConvertRowScalar(const uint8* SourceRow, const int32* Offsets, int32 Count, float* C0, float* C1, float* C2)
+    {
+        for (int32 X = 0; X < Count; X++)
+        {
+            const uint8* Pixel = SourceRow + Offsets[X];
+            C0[X] = static_cast<float>(Pixel[0]) * InvByte;
+            C1[X] = static_cast<float>(Pixel[1]) * InvByte;
+            C2[X] = static_cast<float>(Pixel[2]) * InvByte;
+        }
+    }
+
+    static void ConvertRowSimd(const uint8* SourceRow, const int32* Offsets, int32 Count, float* C0, float* C1, float* C2)
+    {
+        int32 X = 0;
+
+#if NN_PREPROCESS_AVX2
+        {
+            const __m256 Scale = _mm256_set1_ps(InvByte);
+            const __m256i Mask = _mm256_set1_epi32(0xFF);
+            for (; X + 8 <= Count; X += 8)
+            {
+                const __m256i Index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Offsets + X));
+                const __m256i Pixels = _mm256_i32gather_epi32(reinterpret_cast<const int*>(SourceRow), Index, 1);
+
+                _mm256_storeu_ps(C0 + X, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(Pixels, Mask)), Scale));
+                _mm256_storeu_ps(C1 + X, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(Pixels, 8), Mask)), Scale));
+                _mm256_storeu_ps(C2 + X, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(Pixels, 16), Mask)), Scale));
+            }
+        }
+#endif
+
+#if NN_PREPROCESS_SSE
+        {
+            const __m128 Scale = _mm_set1_ps(InvByte);
+            const __m128i Mask = _mm_set1_epi32(0xFF);
+            for (; X + 4 <= Count; X += 4)
+            {
+                const __m128i Pixels = _mm_set_epi32(
+                    FPlatformMemory::ReadUnaligned<int32>(SourceRow + Offsets[X + 3]),
+                    FPlatformMemory::ReadUnaligned<int32>(SourceRow + Offsets[X + 2]),
+                    FPlatformMemory::ReadUnaligned<int32>(SourceRow + Offsets[X + 1]),
+                    FPlatformMemory::ReadUnaligned<int32>(SourceRow + Offsets[X + 0]));
+
+                _mm_storeu_ps(C0 + X, _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(Pixels, Mask)), Scale));
+                _mm_storeu_ps(C1 + X, _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(Pixels, 8), Mask)), Scale));
+                _mm_storeu_ps(C2 + X, _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(Pixels, 16), Mask)), Scale));
+            }
+        }
+#elif NN_PREPROCESS_NEON
+        {
+            const float32x4_t Scale = vdupq_n_f32(InvByte);
+            const uint32x4_t Mask = vdupq_n_u32(0xFF);
+            uint32 Gathered[4];
+            for (; X + 4 <= Count; X += 4)
+            {
+                Gathered[0] = FPlatformMemory::ReadUnaligned<uint32>(SourceRow + Offsets[X + 0]);
+                Gathered[1] = FPlatformMemory::ReadUnaligned<uint32>(SourceRow + Offsets[X + 1]);
+                Gathered[2] = FPlatformMemory::ReadUnaligned<uint32>(SourceRow + Offsets[X + 2]);
+                Gathered[3] = FPlatformMemory::ReadUnaligned<uint32>(SourceRow + Offsets[X + 3]);
+                const uint32x4_t Pixels = vld1q_u32(Gathered);
+
+                vst1q_f32(C0 + X, vmulq_f32(vcvtq_f32_u32(vandq_u32(Pixels, Mask)), Scale));
+                vst1q_f32(C1 + X, vmulq_f32(vcvtq_f32_u32(vandq_u32(vshrq_n_u32(Pixels, 8), Mask)), Scale));
+                vst1q_f32(C2 + X, vmulq_f32(vcvtq_f32_u32(vandq_u32(vshrq_n_u32(Pixels, 16), Mask)), Scale));
+            }
+        }
+#endif
+
+        ConvertRowScalar(SourceRow, Offsets + X, Count - X, C0 + X, C1 + X, C2 + X);
+    }
+
+    template <bool bSimd>
+    static void LetterboxRow(const FNeuralNetworkImageView& Image, const FLetterboxPlan& Plan, int32 TargetWidth, int32 TargetHeight, int32 Y, float* OutTensor)
+    {
+        const int32 PlaneSize = TargetWidth * TargetHeight;
+        float* R = OutTensor + Y * TargetWidth;
+        float* G = R + PlaneSize;
+        float* B = G + PlaneSize;
+
+        const int32 LocalY = Y - Plan.Box.PadY;
+        if (LocalY < 0 || LocalY >= Plan.ScaledHeight)
+        {
+            FillPlanes(R, G, B, TargetWidth);
+            return;
+        }
+
+        const int32 SourceY = FMath::Min(static_cast<int32>((LocalY + 0.5f) / Plan.Box.Scale), Image.Height - 1);
+        const uint8* SourceRow = Image.Pixels + static_cast<int64>(SourceY) * Image.RowStride;
+
+        // FColor memory order is B, G, R, A so the first byte belongs in the blue plane
+        float* C0 = Image.Format == ENeuralNetworkPixelFormat::BGRA8 ? B : R;
+        float* C2 = Image.Format == ENeuralNetworkPixelFormat::BGRA8 ? R : B;
+        const int32 PadX = Plan.Box.PadX;
+
+        FillPlanes(R, G, B, PadX);
+        if (bSimd)
+        {
+            ConvertRowSimd(SourceRow, Plan.Offsets.GetData(), Plan.ScaledWidth, C0 + PadX, G + PadX, C2 + PadX);
+        }
+        else
+        {
+            ConvertRowScalar(SourceRow, Plan.Offsets.GetData(), Plan.ScaledWidth, C0 + PadX, G + PadX, C2 + PadX);
+        }
+        const int32 RightStart = PadX + Plan.ScaledWidth;
+        FillPlanes(R + RightStart, G + RightStart, B + RightStart, TargetWidth - RightStart);
+    }
+}
+
+// ######################################################################################################################
+
+/*
+- Parameters:
+ 1) SourceWidth, SourceHeight: Size of the source image in pixels.
+ 2) TargetWidth, TargetHeight: Size of the model input.
+- What it does: Computes the aspect preserving scale and the centered padding used by the letterbox kernels.
+- Return Value: FNeuralNetworkLetterbox describing the mapping from tensor to source pixels.
+*/
+FNeuralNetworkLetterbox NeuralNetworkPreprocess::ComputeLetterbox(int32 SourceWidth, int32 SourceHeight, int32 TargetWidth, int32 TargetHeight)
+{
+    FNeuralNetworkLetterbox Box;
+    Box.SourceWidth = SourceWidth;
+    Box.SourceHeight = SourceHeight;
+
+    if (SourceWidth < 1 || SourceHeight < 1 || TargetWidth < 1 || TargetHeight < 1)
+    {
+        return Box;
+    }
+
+    Box.Scale = FMath::Min(static_cast<float>(TargetWidth) / SourceWidth, static_cast<float>(TargetHeight) / SourceHeight);
+
+    const int32 ScaledWidth = FMath::Clamp(FMath::RoundToInt(SourceWidth * Box.Scale), 1, TargetWidth);
+    const int32 ScaledHeight = FMath::Clamp(FMath::RoundToInt(SourceHeight * Box.Scale), 1, TargetHeight);
+    Box.PadX = (TargetWidth - ScaledWidth) / 2;
+    Box.PadY = (TargetHeight - ScaledHeight) / 2;
+
+    return Box;
+}
+
+/*
+- Parameters:
+ 1) Image: The interleaved RGBA8 / BGRA8 source pixels.
+ 2) TargetWidth, TargetHeight: Size of the model input.
+ 3) OutTensor: Destination of 3 * TargetWidth * TargetHeight floats (one NCHW batch entry).
+ 4) OutLetterbox: Receives the scale and padding needed to map boxes back to the source image.
+- What it does: Nearest neighbour resizes the image into the tensor while preserving the aspect ratio, pads the borders
+  with YOLO grey, splits the channels into planes and normalizes to [0, 1] in a single pass.
+- Return Value: bool indicating whether the tensor was written.
+*/
+bool NeuralNetworkPreprocess::Letterbox(const FNeuralNetworkImageView& Image, int32 TargetWidth, int32 TargetHeight, float* OutTensor, FNeuralNetworkLetterbox& OutLetterbox)
+{
+    NEURAL_NETWORK_SCOPE(Preprocess);
+
+    if (!ValidateArguments(Image, TargetWidth, TargetHeight, OutTensor))
+    {
+        return false;
+    }
+
+    FLetterboxPlan Plan;
+    BuildPlan(Image, TargetWidth, TargetHeight, Plan);
+
+    const int32 NumTasks = FMath::DivideAndRoundUp(TargetHeight, RowsPerTask);
+    ParallelFor(NumTasks, [&](int32 TaskIndex)
+    {
+        const int32 FirstRow = TaskIndex * RowsPerTask;
+        const int32 LastRow = FMath::Min(FirstRow + RowsPerTask, TargetHeight);
+        for (int32 Y = FirstRow; Y < LastRow; Y++)
+        {
+            LetterboxRow<true>(Image, Plan, TargetWidth, TargetHeight, Y, OutTensor);
+        }
+    });
+
+    OutLetterbox = Plan.Box;
+
+    return true;
+}
+
+/*
+- Parameters: Same as Letterbox.
+- What it does: Plain C++ single threaded version of Letterbox, kept as the reference the SIMD path is checked against.
+- Return Value: bool indicating whether the tensor was written.
+*/
+bool NeuralNetworkPreprocess::LetterboxScalar(const FNeuralNetworkImageView& Image, int32 TargetWidth, int32 TargetHeight, float* OutTensor, FNeuralNetworkLetterbox& OutLetterbox)
+{
+    NEURAL_NETWORK_SCOPE(Preprocess);
+
+    if (!ValidateArguments(Image, TargetWidth, TargetHeight, OutTensor))
+    {
+        return false;
+    }
+
+    FLetterboxPlan Plan;
+    BuildPlan(Image, TargetWidth, TargetHeight, Plan);
+
+    for (int32 Y = 0; Y < TargetHeight; Y++)
+    {
+        LetterboxRow<false>(Image, Plan, TargetWidth, TargetHeight, Y, OutTensor);
+    }
+
+    OutLetterbox = Plan.Box;
+
+    return true;
+}
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkPreprocess.generated.h"
+
+
+// Byte order of the interleaved 8-bit pixels handed to the preprocessing kernels.
+// FColor buffers are BGRA8, IImageWrapper RGBA output is RGBA8.
+UENUM(BlueprintType, Category = "NNE - Tutorial")
+enum class ENeuralNetworkPixelFormat : uint8
+{
+    RGBA8,
+    BGRA8
+};
+
+// Mapping between the letterboxed tensor and the source image:
+// SourcePixel = (TensorPixel - Pad) / Scale
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkLetterbox
+{
+    GENERATED_BODY()
+
+public:
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    float Scale = 1.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 PadX = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 PadY = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 SourceWidth = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 SourceHeight = 0;
+};
+
+// Non-owning view of an interleaved 4 byte per pixel image.
+struct FNeuralNetworkImageView
+{
+    const uint8* Pixels = nullptr;
+    int32 Width = 0;
+    int32 Height = 0;
+    int32 RowStride = 0; // in bytes, >= Width * 4
+    ENeuralNetworkPixelFormat Format = ENeuralNetworkPixelFormat::RGBA8;
+};
+
+namespace NeuralNetworkPreprocess
+{
+    // Grey used by YOLOv8 for the letterbox borders (114 / 255)
+    constexpr float PadValue = 114.0f / 255.0f;
+
+    TUTORIAL_API FNeuralNetworkLetterbox ComputeLetterbox(int32 SourceWidth, int32 SourceHeight, int32 TargetWidth, int32 TargetHeight);
+
+    // Writes a 3 x TargetHeight x TargetWidth planar RGB tensor normalized to [0, 1] into OutTensor.
+    // Uses SSE / AVX2 / NEON when available and splits the rows across the task graph.
+    TUTORIAL_API bool Letterbox(const FNeuralNetworkImageView& Image, int32 TargetWidth, int32 TargetHeight, float* OutTensor, FNeuralNetworkLetterbox& OutLetterbox);
+
+    // Single threaded scalar reference of Letterbox, produces identical output.
+    TUTORIAL_API bool LetterboxScalar(const FNeuralNetworkImageView& Image, int32 TargetWidth, int32 TargetHeight, float* OutTensor, FNeuralNetworkLetterbox& OutLetterbox);
+}
@@ -0,0 +1,397 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkRecording.h"
+#include "NeuralNetworkStats.h"
+
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+
+namespace NeuralNetworkRecording
+{
+    static int64 GetFrameBytes(ENeuralNetworkRecordingFormat Format, int32 Width, int32 Height)
+    {
+        return Format == ENeuralNetworkRecordingFormat::Tensor
+            ? 3 * static_cast<int64>(Width) * Height * sizeof(float)
+            : 4 * static_cast<int64>(Width) * Height;
+    }
+}
+
+// ######################################################################################################################
+
+FNeuralNetworkRecordingWriter::~FNeuralNetworkRecordingWriter()
+{
+    Close();
+}
+
+/*
+- Parameters:
+ 1) Path: The file to create.
+ 2) Format: Whether frames are stored as pixels or as preprocessed tensors.
+ 3) Width, Height: Size of every frame, the image size for Pixels and the tensor size for Tensor recordings.
+ 4) bCompress: Compress each frame with LZ4. Smaller files, but replay has to decompress and cannot bind in place.
+- What it does: Creates the file and reserves the header, which is only written for real on Close.
+- Return Value: bool indicating whether the file could be created.
+*/
+bool FNeuralNetworkRecordingWriter::Open(const FString& Path, ENeuralNetworkRecordingFormat Format, int32 Width, int32 Height, bool bCompress)
+{
+    using namespace NeuralNetworkRecording;
+
+    Close();
+
+    if (Width < 1 || Height < 1)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RecordingWriter: Invalid frame size %dx%d"), Width, Height);
+        return false;
+    }
+
+    File.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Path));
+    if (!File.IsValid())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RecordingWriter: Could not create %s"), *Path);
+        return false;
+    }
+
+    Header = FHeader();
+    Header.Magic = Magic;
+    Header.Version = Version;
+    Header.Flags = bCompress ? FlagLZ4 : 0;
+    Header.Format = static_cast<uint8>(Format);
+    Header.Width = Width;
+    Header.Height = Height;
+    Header.FrameBytes = GetFrameBytes(Format, Width, Height);
+    Entries.Reset();
+
+    // Zeroed until Close, so an interrupted recording is recognizably incomplete
+    TArray<uint8> Zeros;
+    Zeros.SetNumZeroed(HeaderBytes);
+    if (!File->Write(Zeros.GetData(), Zeros.Num()))
+    {
+        File.Reset();
+        return false;
+    }
+    WriteOffset = HeaderBytes;
+
+    UE_LOG(LogNeuralNetwork, Log, TEXT("RecordingWriter: Recording %dx%d %s frames to %s%s"), Width, Height,
+        Format == ENeuralNetworkRecordingFormat::Tensor ? TEXT("tensor") : TEXT("pixel"), *Path, bCompress ? TEXT(" (LZ4)") : TEXT(""));
+    return true;
+}
+
+/*
+- Parameters:
+ 1) Image: The captured frame, any row stride.
+ 2) CaptureTime: Stored with the frame for replay pacing.
+- What it does: Appends the frame's pixels, rows tightly packed. The first frame fixes the pixel format.
+- Return Value: bool indicating whether the frame was written.
+*/
+bool FNeuralNetworkRecordingWriter::WriteImage(const FNeuralNetworkImageView& Image, double CaptureTime)
+{
+    if (!File.IsValid() || GetFormat() != ENeuralNetworkRecordingFormat::Pixels || !Image.Pixels)
+    {
+        return false;
+    }
+
+    if (Image.Width != Header.Width || Image.Height != Header.Height)
+    {
+        UE_LOG(LogNeuralNetwork, Warning, TEXT("RecordingWriter: Skipping a %dx%d frame, the recording is %dx%d"), Image.Width, Image.Height, Header.Width, Header.Height);
+        return false;
+    }
+
+    if (Entries.Num() == 0)
+    {
+        Header.PixelFormat = static_cast<uint8>(Image.Format);
+    }
+    else if (Header.PixelFormat != static_cast<uint8>(Image.Format))
+    {
+        UE_LOG(LogNeuralNetwork, Warning, TEXT("RecordingWriter: Skipping a frame with a different pixel format"));
+        return false;
+    }
+
+    const int32 RowBytes = Image.Width * 4;
+    const uint8* Data = Image.Pixels;
+    if (Image.RowStride != RowBytes)
+    {
+        Staging.SetNumUninitialized(RowBytes * Image.Height, false);
+        for (int32 Y = 0; Y < Image.Height; Y++)
+        {
+            FMemory::Memcpy(Staging.GetData() + Y * RowBytes, Image.Pixels + static_cast<int64>(Y) * Image.RowStride, RowBytes);
+        }
+        Data = Staging.GetData();
+    }
+
+    FNeuralNetworkLetterbox Letterbox;
+    Letterbox.SourceWidth = Image.Width;
+    Letterbox.SourceHeight = Image.Height;
+    return WriteFrame(Data, Letterbox, CaptureTime);
+}
+
+/*
+- Parameters:
+ 1) Tensor: The preprocessed 1x3xHxW input.
+ 2) Letterbox: The mapping of the tensor back to its image, stored so replayed detections land in source pixels.
+ 3) CaptureTime: Stored with the frame for replay pacing.
+- What it does: Appends the tensor.
+- Return Value: bool indicating whether the frame was written.
+*/
+bool FNeuralNetworkRecordingWriter::WriteTensor(TConstArrayView<float> Tensor, const FNeuralNetworkLetterbox& Letterbox, double CaptureTime)
+{
+    if (!File.IsValid() || GetFormat() != ENeuralNetworkRecordingFormat::Tensor)
+    {
+        return false;
+    }
+
+    if (static_cast<uint64>(Tensor.Num()) * sizeof(float) != Header.FrameBytes)
+    {
+        UE_LOG(LogNeuralNetwork, Warning, TEXT("RecordingWriter: Skipping a tensor of %d elements, the recording is 3x%dx%d"), Tensor.Num(), Header.Height, Header.Width);
+        return false;
+    }
+
+    return WriteFrame(reinterpret_cast<const uint8*>(Tensor.GetData()), Letterbox, CaptureTime);
+}
+
+bool FNeuralNetworkRecordingWriter::WriteFrame(const uint8* Data, const FNeuralNetworkLetterbox& Letterbox, double CaptureTime)
+{
+    using namespace NeuralNetworkRecording;
+
+    const int64 FrameBytes = static_cast<int64>(Header.FrameBytes);
+    const uint8* Stored = Data;
+    int64 StoredBytes = FrameBytes;
+
+    if (Header.Flags & FlagLZ4)
+    {
+        int32 CompressedBytes = FCompression::CompressMemoryBound(NAME_LZ4, static_cast<int32>(FrameBytes));
+        Compressed.SetNumUninitialized(CompressedBytes, false);
+        if (FCompression::CompressMemory(NAME_LZ4, Compressed.GetData(), CompressedBytes, Data, static_cast<int32>(FrameBytes)) && CompressedBytes < FrameBytes)
+        {
+            Stored = Compressed.GetData();
+            StoredBytes = CompressedBytes;
+        }
+    }
+
+    // Every frame starts aligned, so raw frames can be used in place from the mapping
+    static const uint8 Zeros[FrameAlignment] = {};
+    const int64 FrameOffset = Align(WriteOffset, FrameAlignment);
+    if (FrameOffset > WriteOffset && !File->Write(Zeros, FrameOffset - WriteOffset))
+    {
+        return false;
+    }
+    if (!File->Write(Stored, StoredBytes))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RecordingWriter: Write failed after %d frames"), Entries.Num());
+        return false;
+    }
+    WriteOffset = FrameOffset + StoredBytes;
+
+    FFrameEntry& Entry = Entries.AddDefaulted_GetRef();
+    Entry.Offset = FrameOffset;
+    Entry.StoredBytes = StoredBytes;
+    Entry.CaptureTime = CaptureTime;
+    Entry.LetterboxScale = Letterbox.Scale;
+    Entry.PadX = Letterbox.PadX;
+    Entry.PadY = Letterbox.PadY;
+    Entry.SourceWidth = Letterbox.SourceWidth;
+    Entry.SourceHeight = Letterbox.SourceHeight;
+    return true;
+}
+
+/*
+- Parameters: None.
+- What it does: Appends the frame index and fills in the header. Called by the destructor if needed.
+- Return Value: bool indicating whether the recording is complete on disk.
+*/
+bool FNeuralNetworkRecordingWriter::Close()
+{
+    if (!File.IsValid())
+    {
+        return false;
+    }
+
+    Header.FrameCount = Entries.Num();
+    Header.IndexOffset = WriteOffset;
+
+    const bool bSuccess = File->Write(reinterpret_cast<const uint8*>(Entries.GetData()), Entries.Num() * sizeof(NeuralNetworkRecording::FFrameEntry))
+        && File->Seek(0)
+        && File->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header))
+        && File->Flush();
+
+    if (!bSuccess)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RecordingWriter: Could not finish the recording"));
+    }
+    else
+    {
+        UE_LOG(LogNeuralNetwork, Log, TEXT("RecordingWriter: Wrote %d frames, %.1f MB"), Entries.Num(), (WriteOffset + Entries.Num() * sizeof(NeuralNetworkRecording::FFrameEntry)) / (1024.0 * 1024.0));
+    }
+
+    File.Reset();
+    Entries.Reset();
+    return bSuccess;
+}
+
+// ######################################################################################################################
+
+FNeuralNetworkRecordingReader::~FNeuralNetworkRecordingReader()
+{
+    Close();
+}
+
+/*
+- Parameters:
+ 1) Path: The recording to open.
+- What it does: Maps the whole file (or loads it where mapping is not available) and validates the header and index.
+- Return Value: bool indicating whether the recording can be replayed.
+*/
+bool FNeuralNetworkRecordingReader::Open(const FString& Path)
+{
+    using namespace NeuralNetworkRecording;
+
+    Close();
+
+    MappedFile = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path);
+    if (MappedFile)
+    {
+        MappedRegion = MappedFile->MapRegion(0, MappedFile->GetFileSize());
+    }
+
+    if (MappedRegion)
+    {
+        Data = MappedRegion->GetMappedPtr();
+        Size = MappedRegion->GetMappedSize();
+    }
+    else
+    {
+        delete MappedFile;
+        MappedFile = nullptr;
+
+        if (!FFileHelper::LoadFileToArray(FileData, *Path))
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RecordingReader: Could not open %s"), *Path);
+            return false;
+        }
+        UE_LOG(LogNeuralNetwork, Log, TEXT("RecordingReader: Memory mapping is not available, loaded %s into memory"), *Path);
+        Data = FileData.GetData();
+        Size = FileData.Num();
+    }
+
+    if (Size >= HeaderBytes)
+    {
+        FMemory::Memcpy(&Header, Data, sizeof(Header));
+    }
+
+    const int64 IndexBytes = static_cast<int64>(Header.FrameCount) * sizeof(FFrameEntry);
+    const ENeuralNetworkRecordingFormat Format = static_cast<ENeuralNetworkRecordingFormat>(Header.Format);
+    if (Size < HeaderBytes || Header.Magic != Magic || Header.Version != Version || Header.FrameCount == 0
+        || Header.FrameBytes != static_cast<uint64>(GetFrameBytes(Format, Header.Width, Header.Height))
+        || Header.IndexOffset < static_cast<uint64>(HeaderBytes) || static_cast<int64>(Header.IndexOffset) + IndexBytes > Size)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RecordingReader: %s is not a complete recording"), *Path);
+        Close();
+        return false;
+    }
+
+    Entries.SetNumUninitialized(static_cast<int32>(Header.FrameCount));
+    FMemory::Memcpy(Entries.GetData(), Data + Header.IndexOffset, IndexBytes);
+
+    for (const FFrameEntry& Entry : Entries)
+    {
+        if (Entry.StoredBytes == 0 || Entry.StoredBytes > Header.FrameBytes || Entry.Offset + Entry.StoredBytes > Header.IndexOffset
+            || (Entry.StoredBytes < Header.FrameBytes && !(Header.Flags & FlagLZ4)))
+        {
+            UE_LOG(LogNeuralNetwork, Error, TEXT("RecordingReader: %s has a corrupt frame index"), *Path);
+            Close();
+            return false;
+        }
+    }
+
+    UE_LOG(LogNeuralNetwork, Log, TEXT("RecordingReader: %s, %d %dx%d %s frames"), *Path, Entries.Num(), Header.Width, Header.Height,
+        Format == ENeuralNetworkRecordingFormat::Tensor ? TEXT("tensor") : TEXT("pixel"));
+    return true;
+}
+
+void FNeuralNetworkRecordingReader::Close()
+{
+    // The region has to go before its file
+    delete MappedRegion;
+    MappedRegion = nullptr;
+    delete MappedFile;
+    MappedFile = nullptr;
+
+    FileData.Empty();
+    Data = nullptr;
+    Size = 0;
+    Header = NeuralNetworkRecording::FHeader();
+    Entries.Reset();
+}
+
+/*
+- Parameters:
+ 1) Index: The frame.
+ 2) Scratch: Receives the decompressed frame for LZ4 frames, untouched otherwise.
+- What it does: Locates the frame's bytes, decompressing only when needed.
+- Return Value: const uint8* to Header.FrameBytes bytes, nullptr on failure.
+*/
+const uint8* FNeuralNetworkRecordingReader::GetFrame(int32 Index, TArray<uint8>& Scratch) const
+{
+    if (!Entries.IsValidIndex(Index))
+    {
+        return nullptr;
+    }
+
+    const NeuralNetworkRecording::FFrameEntry& Entry = Entries[Index];
+    if (Entry.StoredBytes == Header.FrameBytes)
+    {
+        return Data + Entry.Offset;
+    }
+
+    Scratch.SetNumUninitialized(static_cast<int32>(Header.FrameBytes), false);
+    if (!FCompression::UncompressMemory(NAME_LZ4, Scratch.GetData(), Scratch.Num(), Data + Entry.Offset, static_cast<int32>(Entry.StoredBytes)))
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("RecordingReader: Could not decompress frame %d"), Index);
+        return nullptr;
+    }
+    return Scratch.GetData();
+}
+
+bool FNeuralNetworkRecordingReader::GetImage(int32 Index, TArray<uint8>& Scratch, FNeuralNetworkImageView& OutImage, double* OutCaptureTime) const
+{
+    const uint8* Frame = GetFormat() == ENeuralNetworkRecordingFormat::Pixels ? GetFrame(Index, Scratch) : nullptr;
+    if (!Frame)
+    {
+        return false;
+    }
+
+    OutImage.Pixels = Frame;
+    OutImage.Width = Header.Width;
+    OutImage.Height = Header.Height;
+    OutImage.RowStride = Header.Width * 4;
+    OutImage.Format = static_cast<ENeuralNetworkPixelFormat>(Header.PixelFormat);
+    if (OutCaptureTime)
+    {
+        *OutCaptureTime = Entries[Index].CaptureTime;
+    }
+    return true;
+}
+
+bool FNeuralNetworkRecordingReader::GetTensor(int32 Index, TArray<uint8>& Scratch, TConstArrayView<float>& OutTensor, FNeuralNetworkLetterbox& OutLetterbox, double* OutCaptureTime) const
+{
+    const uint8* Frame = GetFormat() == ENeuralNetworkRecordingFormat::Tensor ? GetFrame(Index, Scratch) : nullptr;
+    if (!Frame)
+    {
+        return false;
+    }
+
+    const NeuralNetworkRecording::FFrameEntry& Entry = Entries[Index];
+    OutTensor = TConstArrayView<float>(reinterpret_cast<const float*>(Frame), static_cast<int32>(Header.FrameBytes / sizeof(float)));
+    OutLetterbox.Scale = Entry.LetterboxScale;
+    OutLetterbox.PadX = Entry.PadX;
+    OutLetterbox.PadY = Entry.PadY;
+    OutLetterbox.SourceWidth = Entry.SourceWidth;
+    OutLetterbox.SourceHeight = Entry.SourceHeight;
+    if (OutCaptureTime)
+    {
+        *OutCaptureTime = Entry.CaptureTime;
+    }
+    return true;
+}
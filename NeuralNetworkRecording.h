@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkPreprocess.h"
+
+#include "NeuralNetworkRecording.generated.h"
+
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+
+// What a recording stores per frame
+UENUM(BlueprintType, Category = "NNE - Tutorial")
+enum class ENeuralNetworkRecordingFormat : uint8
+{
+    // The captured 8-bit pixels, replay still runs the preprocessing
+    Pixels,
+    // The preprocessed 1x3xHxW float tensor and its letterbox, replay binds it straight to the model
+    Tensor
+};
+
+/*
+ File layout, little endian:
+
+ [FHeader, padded to HeaderBytes] [frame 0] [frame 1] ... [FFrameEntry x FrameCount]
+
+ Uncompressed frames are FrameBytes long and start on a 64 byte boundary, so a mapped tensor frame can be bound to the
+ model in place. LZ4 frames are stored as is, or raw when they did not compress; FFrameEntry::StoredBytes tells which.
+ The index is written last, a recording whose writer never closed has FrameCount 0 and is rejected.
+*/
+namespace NeuralNetworkRecording
+{
+    constexpr uint32 Magic = 0x43524E4E; // "NNRC"
+    constexpr uint32 Version = 1;
+    constexpr uint32 FlagLZ4 = 1u << 0;
+    constexpr int64 HeaderBytes = 4096;
+    constexpr int64 FrameAlignment = 64;
+
+    struct FHeader
+    {
+        uint32 Magic = 0;
+        uint32 Version = 0;
+        uint32 Flags = 0;
+        uint8 Format = 0;      // ENeuralNetworkRecordingFormat
+        uint8 PixelFormat = 0; // ENeuralNetworkPixelFormat, Pixels recordings only
+        uint16 Reserved = 0;
+        int32 Width = 0;       // Image size for Pixels, tensor size for Tensor recordings
+        int32 Height = 0;
+        uint64 FrameBytes = 0;
+        uint64 FrameCount = 0;
+        uint64 IndexOffset = 0;
+    };
+    static_assert(sizeof(FHeader) == 48, "The recording header is part of the file format");
+
+    struct FFrameEntry
+    {
+        uint64 Offset = 0;
+        uint64 StoredBytes = 0;
+        double CaptureTime = 0.0;
+        float LetterboxScale = 1.0f;
+        int32 PadX = 0;
+        int32 PadY = 0;
+        int32 SourceWidth = 0;
+        int32 SourceHeight = 0;
+        uint32 Padding = 0;
+    };
+    static_assert(sizeof(FFrameEntry) == 48, "The recording index is part of the file format");
+}
+
+// Appends fixed size frames to a recording. Not thread safe.
+class TUTORIAL_API FNeuralNetworkRecordingWriter
+{
+public:
+
+    ~FNeuralNetworkRecordingWriter();
+
+    // Width and Height are the image size for Pixels and the tensor size for Tensor recordings
+    bool Open(const FString& Path, ENeuralNetworkRecordingFormat Format, int32 Width, int32 Height, bool bCompress);
+
+    // Pixels recordings: the image must have the recording's size, rows are stored tightly packed
+    bool WriteImage(const FNeuralNetworkImageView& Image, double CaptureTime);
+
+    // Tensor recordings: 3 x Height x Width floats
+    bool WriteTensor(TConstArrayView<float> Tensor, const FNeuralNetworkLetterbox& Letterbox, double CaptureTime);
+
+    // Writes the index and the final header
+    bool Close();
+
+    bool IsOpen() const { return File.IsValid(); }
+    ENeuralNetworkRecordingFormat GetFormat() const { return static_cast<ENeuralNetworkRecordingFormat>(Header.Format); }
+    int32 Num() const { return Entries.Num(); }
+
+private:
+
+    bool WriteFrame(const uint8* Data, const FNeuralNetworkLetterbox& Letterbox, double CaptureTime);
+
+    TUniquePtr<IFileHandle> File;
+    NeuralNetworkRecording::FHeader Header;
+    TArray<NeuralNetworkRecording::FFrameEntry> Entries;
+    TArray<uint8> Staging;
+    TArray<uint8> Compressed;
+    int64 WriteOffset = 0;
+};
+
+// Memory maps a recording for replay. Uncompressed frames are returned as views into the mapping, no copy and no
+// read call; LZ4 frames are decompressed into a caller provided scratch buffer. Read only, safe from any thread.
+class TUTORIAL_API FNeuralNetworkRecordingReader
+{
+public:
+
+    ~FNeuralNetworkRecordingReader();
+
+    bool Open(const FString& Path);
+    void Close();
+
+    bool IsOpen() const { return Data != nullptr; }
+    int32 Num() const { return Entries.Num(); }
+    ENeuralNetworkRecordingFormat GetFormat() const { return static_cast<ENeuralNetworkRecordingFormat>(Header.Format); }
+    int32 GetWidth() const { return Header.Width; }
+    int32 GetHeight() const { return Header.Height; }
+    bool IsMapped() const { return MappedRegion != nullptr; }
+
+    // Pixels recordings
+    bool GetImage(int32 Index, TArray<uint8>& Scratch, FNeuralNetworkImageView& OutImage, double* OutCaptureTime = nullptr) const;
+
+    // Tensor recordings
+    bool GetTensor(int32 Index, TArray<uint8>& Scratch, TConstArrayView<float>& OutTensor, FNeuralNetworkLetterbox& OutLetterbox, double* OutCaptureTime = nullptr) const;
+
+private:
+
+    const uint8* GetFrame(int32 Index, TArray<uint8>& Scratch) const;
+
+    IMappedFileHandle* MappedFile = nullptr;
+    IMappedFileRegion* MappedRegion = nullptr;
+
+    // Whole file in memory where the platform cannot map files
+    TArray64<uint8> FileData;
+
+    const uint8* Data = nullptr;
+    int64 Size = 0;
+    NeuralNetworkRecording::FHeader Header;
+    TArray<NeuralNetworkRecording::FFrameEntry> Entries;
+};
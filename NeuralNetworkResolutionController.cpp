@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkResolutionController.h"
+#include "NeuralNetworkStats.h"
+
+// ######################################################################################################################
+
+/*
+- Parameters:
+ 1) InSettings: Candidate sizes, budget and hysteresis.
+- What it does: Sorts the candidate sizes and starts at the largest, the controller steps down from there if needed.
+- Return Value: None.
+*/
+FNeuralNetworkResolutionController::FNeuralNetworkResolutionController(const FNeuralNetworkResolutionSettings& InSettings)
+    : Settings(InSettings)
+{
+    for (int32 Size : Settings.InputSizes)
+    {
+        if (Size >= 32)
+        {
+            Sizes.AddUnique(Size);
+        }
+    }
+    if (Sizes.Num() == 0)
+    {
+        Sizes.Add(640);
+    }
+    Sizes.Sort();
+
+    Settings.Smoothing = FMath::Clamp(Settings.Smoothing, 0.01f, 1.0f);
+    Current = Sizes.Num() - 1;
+    SET_DWORD_STAT(STAT_NeuralNetwork_InputSize, Sizes[Current]);
+}
+
+/*
+- Parameters:
+ 1) Milliseconds: Inference time of the frame just run at GetInputSize().
+- What it does: Updates the moving average and the budget statistics. Outside the cooldown it steps one size down
+  when the average is over budget, or one size up when the average scaled by the pixel ratio of the larger size is
+  still below UpscaleHeadroom of the budget.
+- Return Value: bool, true when GetInputSize() changed.
+*/
+bool FNeuralNetworkResolutionController::ReportLatency(double Milliseconds)
+{
+    Last = Milliseconds;
+    Frames++;
+    if (Milliseconds > Settings.BudgetMilliseconds)
+    {
+        BudgetMisses++;
+        INC_DWORD_STAT(STAT_NeuralNetwork_BudgetMisses);
+    }
+
+    // The first sample after a switch seeds the average for the new size
+    Average = FramesSinceSwitch == 0 ? Milliseconds : FMath::Lerp(Average, Milliseconds, static_cast<double>(Settings.Smoothing));
+    FramesSinceSwitch++;
+
+    if (FramesSinceSwitch < FMath::Max(1, Settings.MinFramesBetweenSwitches))
+    {
+        return false;
+    }
+
+    if (Average > Settings.BudgetMilliseconds && Current > 0)
+    {
+        SwitchTo(Current - 1);
+        return true;
+    }
+
+    if (Current + 1 < Sizes.Num())
+    {
+        const double PixelRatio = FMath::Square(static_cast<double>(Sizes[Current + 1]) / Sizes[Current]);
+        if (Average * PixelRatio < Settings.BudgetMilliseconds * Settings.UpscaleHeadroom)
+        {
+            SwitchTo(Current + 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+FNeuralNetworkResolutionStats FNeuralNetworkResolutionController::GetStats() const
+{
+    FNeuralNetworkResolutionStats Stats;
+    Stats.InputSize = Sizes[Current];
+    Stats.AverageMilliseconds = static_cast<float>(Average);
+    Stats.LastMilliseconds = static_cast<float>(Last);
+    Stats.Frames = Frames;
+    Stats.BudgetMisses = BudgetMisses;
+    Stats.Switches = Switches;
+    return Stats;
+}
+
+void FNeuralNetworkResolutionController::SwitchTo(int32 Index)
+{
+    UE_LOG(LogNeuralNetwork, Log, TEXT("Resolution controller: %d -> %d (average %.2f ms, budget %.2f ms)"),
+        Sizes[Current], Sizes[Index], Average, Settings.BudgetMilliseconds);
+
+    Current = Index;
+    FramesSinceSwitch = 0;
+    Switches++;
+    SET_DWORD_STAT(STAT_NeuralNetwork_InputSize, Sizes[Current]);
+}
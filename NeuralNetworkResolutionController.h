@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkResolutionController.generated.h"
+
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkResolutionSettings
+{
+    GENERATED_BODY()
+
+public:
+
+    // Square input sizes to choose from, multiples of 32 for YOLOv8. The model needs dynamic height and width.
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    TArray<int32> InputSizes = { 320, 416, 512, 640 };
+
+    // Inference time per frame to stay under
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float BudgetMilliseconds = 8.0f;
+
+    // Weight of the newest sample in the moving average of the latency
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float Smoothing = 0.2f;
+
+    // Step up only if the latency predicted for the next larger size is below this fraction of the budget
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float UpscaleHeadroom = 0.8f;
+
+    // Frames to wait after a switch before the next one, so the average settles on the new size first
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 MinFramesBetweenSwitches = 30;
+};
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkResolutionStats
+{
+    GENERATED_BODY()
+
+public:
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 InputSize = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    float AverageMilliseconds = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    float LastMilliseconds = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 Frames = 0;
+
+    // Frames whose inference took longer than the budget
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 BudgetMisses = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 Switches = 0;
+};
+
+// Picks the input size for the next frame from the measured inference latency. Steps down as soon as the moving
+// average is over budget and up only when the larger size is predicted to fit with headroom, with a cooldown after
+// every switch, so it settles instead of oscillating between two sizes. Not thread safe.
+class TUTORIAL_API FNeuralNetworkResolutionController
+{
+public:
+
+    explicit FNeuralNetworkResolutionController(const FNeuralNetworkResolutionSettings& InSettings);
+
+    int32 GetInputSize() const { return Sizes[Current]; }
+
+    // Feeds the latency of a run at GetInputSize(). Returns true when the size for the next frame changed.
+    bool ReportLatency(double Milliseconds);
+
+    FNeuralNetworkResolutionStats GetStats() const;
+
+private:
+
+    void SwitchTo(int32 Index);
+
+    FNeuralNetworkResolutionSettings Settings;
+    TArray<int32> Sizes;
+    int32 Current = 0;
+
+    double Average = 0.0;
+    double Last = 0.0;
+    int32 FramesSinceSwitch = 0;
+
+    int64 Frames = 0;
+    int64 BudgetMisses = 0;
+    int32 Switches = 0;
+};
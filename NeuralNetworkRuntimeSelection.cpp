@@ -0,0 +1,181 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkRuntimeSelection.h"
+#include "NeuralNetworkModel.h"
+#include "NeuralNetworkModelCache.h"
+#include "NeuralNetworkStats.h"
+
+#include "NNE.h"
+#include "NNERuntimeCPU.h"
+#include "HAL/PlatformMisc.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+namespace NeuralNetworkRuntimeSelection
+{
+    static const TCHAR* ConfigSection = TEXT("NeuralNetworkRuntime");
+
+    // Runs per runtime, the first one pays for lazy initialization and is not timed
+    static constexpr int32 BenchmarkRuns = 6;
+
+    // Serializes access to the ini file and LastSelection
+    static FCriticalSection SelectionLock;
+    static FNeuralNetworkRuntimeSelection LastSelection;
+
+    static FString GetConfigPath()
+    {
+        return FPaths::ProjectSavedDir() / TEXT("Config") / TEXT("NeuralNetworkRuntime.ini");
+    }
+
+    // One entry per model and CPU, so a Saved folder copied to another machine is measured again there
+    static FString GetConfigKey(UNNEModelData* ModelData)
+    {
+        FString Key = ModelData->GetPathName() + TEXT("@") + FPlatformMisc::GetCPUBrand().TrimStartAndEnd();
+        Key.ReplaceCharInline(TEXT('='), TEXT('_'));
+        Key.ReplaceCharInline(TEXT(' '), TEXT('_'));
+        return Key;
+    }
+
+    // OutModel keeps the measured model alive, the caller holds on to the winner's handle only
+    static FNeuralNetworkRuntimeTiming Benchmark(UNNEModelData* ModelData, const FString& RuntimeName, TSharedPtr<UE::NNE::IModelCPU>& OutModel)
+    {
+        FNeuralNetworkRuntimeTiming Timing;
+        Timing.RuntimeName = RuntimeName;
+
+        // Through the cache, so CreateModel gets the same model while the winner's handle is held
+        OutModel = FNeuralNetworkModelCache::Get().FindOrCreate(ModelData, RuntimeName);
+        TSharedPtr<UE::NNE::IModelInstanceCPU> Instance = OutModel.IsValid() ? OutModel->CreateModelInstanceCPU() : nullptr;
+
+        TArray<UE::NNE::FTensorShape> Shapes;
+        double MeanMilliseconds = 0.0;
+        Timing.bSucceeded = Instance.IsValid() && UNeuralNetworkModel::WarmUpInstance(*Instance, BenchmarkRuns, Shapes, &MeanMilliseconds);
+        Timing.MeanMilliseconds = Timing.bSucceeded ? static_cast<float>(MeanMilliseconds) : 0.0f;
+        return Timing;
+    }
+}
+
+// ######################################################################################################################
+
+bool NeuralNetworkRuntimeSelection::IsAuto(const FString& RuntimeName)
+{
+    return RuntimeName.IsEmpty() || RuntimeName.Equals(AutoRuntimeName, ESearchCase::IgnoreCase);
+}
+
+TArray<FString> NeuralNetworkRuntimeSelection::GetCpuRuntimeNames()
+{
+    TArray<FString> Names;
+    for (const FString& Name : UE::NNE::GetAllRuntimeNames())
+    {
+        if (UE::NNE::GetRuntime<INNERuntimeCPU>(Name).IsValid())
+        {
+            Names.Add(Name);
+        }
+    }
+    return Names;
+}
+
+/*
+- Parameters:
+ 1) ModelData: The model to run.
+ 2) bForceBenchmark: Ignore a cached choice and measure again.
+ 3) OutModel: Optional, receives the winner's model after a benchmark so it is not loaded twice, left empty for a
+    cached choice.
+- What it does: Looks up the choice cached for this model and CPU. Without one (or if that runtime is gone), prepares
+  each CPU runtime for the model's default input shape, runs it a few times and keeps the fastest. The timings are
+  logged once, when they are measured. The lock only covers the ini file and LastSelection, benchmarks of different
+  models run concurrently.
+- Return Value: FString name of the selected runtime, empty if none can run the model.
+*/
+FString NeuralNetworkRuntimeSelection::SelectRuntime(UNNEModelData* ModelData, bool bForceBenchmark, TSharedPtr<UE::NNE::IModelCPU>* OutModel)
+{
+    if (!ModelData)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("SelectRuntime failed: ModelData is null"));
+        return FString();
+    }
+
+    const TArray<FString> Candidates = GetCpuRuntimeNames();
+    const FString ConfigPath = GetConfigPath();
+    const FString Key = GetConfigKey(ModelData);
+
+    if (!bForceBenchmark)
+    {
+        FScopeLock ScopeLock(&SelectionLock);
+
+        FConfigFile Config;
+        Config.Read(ConfigPath);
+
+        FString Cached;
+        if (Config.GetString(ConfigSection, *Key, Cached) && Candidates.Contains(Cached))
+        {
+            if (LastSelection.SelectedRuntime != Cached)
+            {
+                UE_LOG(LogNeuralNetwork, Log, TEXT("SelectRuntime: Using %s for %s, measured earlier on this machine"), *Cached, *ModelData->GetName());
+            }
+            LastSelection = FNeuralNetworkRuntimeSelection();
+            LastSelection.SelectedRuntime = Cached;
+            LastSelection.bFromCache = true;
+            return Cached;
+        }
+    }
+
+    FNeuralNetworkRuntimeSelection Selection;
+    TSharedPtr<UE::NNE::IModelCPU> BestModel;
+    float BestMilliseconds = TNumericLimits<float>::Max();
+    for (const FString& RuntimeName : Candidates)
+    {
+        TSharedPtr<UE::NNE::IModelCPU> Model;
+        const FNeuralNetworkRuntimeTiming& Timing = Selection.Timings.Add_GetRef(Benchmark(ModelData, RuntimeName, Model));
+        if (Timing.bSucceeded)
+        {
+            UE_LOG(LogNeuralNetwork, Log, TEXT("SelectRuntime: %-24s %8.3f ms"), *RuntimeName, Timing.MeanMilliseconds);
+        }
+        else
+        {
+            UE_LOG(LogNeuralNetwork, Log, TEXT("SelectRuntime: %-24s cannot run %s"), *RuntimeName, *ModelData->GetName());
+        }
+
+        if (Timing.bSucceeded && Timing.MeanMilliseconds < BestMilliseconds)
+        {
+            BestMilliseconds = Timing.MeanMilliseconds;
+            Selection.SelectedRuntime = RuntimeName;
+            BestModel = MoveTemp(Model);
+        }
+    }
+
+    FScopeLock ScopeLock(&SelectionLock);
+
+    if (Selection.SelectedRuntime.IsEmpty())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("SelectRuntime failed: None of the %d CPU runtimes can run %s"), Candidates.Num(), *ModelData->GetName());
+        LastSelection = MoveTemp(Selection);
+        return FString();
+    }
+
+    UE_LOG(LogNeuralNetwork, Log, TEXT("SelectRuntime: Selected %s for %s"), *Selection.SelectedRuntime, *ModelData->GetName());
+
+    // Read again, another model may have stored its choice while this one was measured
+    FConfigFile Config;
+    Config.Read(ConfigPath);
+    Config.SetString(ConfigSection, *Key, *Selection.SelectedRuntime);
+    if (!Config.Write(ConfigPath))
+    {
+        UE_LOG(LogNeuralNetwork, Warning, TEXT("SelectRuntime: Could not write %s, the runtimes will be measured again next time"), *ConfigPath);
+    }
+
+    if (OutModel)
+    {
+        *OutModel = MoveTemp(BestModel);
+    }
+
+    LastSelection = MoveTemp(Selection);
+    return LastSelection.SelectedRuntime;
+}
+
+FNeuralNetworkRuntimeSelection NeuralNetworkRuntimeSelection::GetLastSelection()
+{
+    FScopeLock ScopeLock(&SelectionLock);
+    return LastSelection;
+}
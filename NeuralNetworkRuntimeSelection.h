@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NNEModelData.h"
+#include "NNERuntimeCPU.h"
+
+#include "NeuralNetworkRuntimeSelection.generated.h"
+
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkRuntimeTiming
+{
+    GENERATED_BODY()
+
+public:
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    FString RuntimeName;
+
+    // Mean inference time on the model's input shape after warm-up, 0 if the runtime could not run the model
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    float MeanMilliseconds = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    bool bSucceeded = false;
+};
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkRuntimeSelection
+{
+    GENERATED_BODY()
+
+public:
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    FString SelectedRuntime;
+
+    // Empty when the choice was read from the machine's cache instead of being measured
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    TArray<FNeuralNetworkRuntimeTiming> Timings;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    bool bFromCache = false;
+};
+
+namespace NeuralNetworkRuntimeSelection
+{
+    // Runtime name that asks CreateModel to pick the runtime itself, an empty name does the same
+    inline const TCHAR* AutoRuntimeName = TEXT("Auto");
+
+    TUTORIAL_API bool IsAuto(const FString& RuntimeName);
+
+    // Names of the registered runtimes that implement the CPU interface
+    TUTORIAL_API TArray<FString> GetCpuRuntimeNames();
+
+    // Returns the fastest CPU runtime for the model on this machine. The first call per model measures every CPU
+    // runtime and stores the winner in Saved/Config/NeuralNetworkRuntime.ini, later calls read it from there.
+    // Safe to call from any thread. Returns an empty string if no runtime can run the model. After a benchmark OutModel
+    // receives the winner's already loaded model.
+    TUTORIAL_API FString SelectRuntime(UNNEModelData* ModelData, bool bForceBenchmark = false, TSharedPtr<UE::NNE::IModelCPU>* OutModel = nullptr);
+
+    // Result of the last SelectRuntime call
+    TUTORIAL_API FNeuralNetworkRuntimeSelection GetLastSelection();
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkSequenceCommandlet.h"
+#include "NeuralNetworkModel.h"
+#include "NeuralNetworkStats.h"
+
+#include "UObject/Package.h"
+
+UNeuralNetworkSequenceCommandlet::UNeuralNetworkSequenceCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+}
+
+/*
+- Parameters:
+ 1) Params: The command line, see the header for the accepted switches.
+- What it does: Creates the model and runs DetectImageSequence over the folder.
+- Return Value: int32 process exit code, 0 on success.
+*/
+int32 UNeuralNetworkSequenceCommandlet::Main(const FString& Params)
+{
+    FString ModelPath = TEXT("/Game/yolov8n");
+    FString RuntimeName = NeuralNetworkRuntimeSelection::AutoRuntimeName;
+    FNeuralNetworkImageSequenceSettings SequenceSettings;
+    FNeuralNetworkDecodeSettings Settings;
+
+    FParse::Value(*Params, TEXT("Model="), ModelPath);
+    FParse::Value(*Params, TEXT("Runtime="), RuntimeName);
+    FParse::Value(*Params, TEXT("ImageDir="), SequenceSettings.Directory);
+    FParse::Value(*Params, TEXT("Output="), SequenceSettings.OutputPath);
+    FParse::Value(*Params, TEXT("BatchSize="), SequenceSettings.BatchSize);
+    FParse::Value(*Params, TEXT("InFlight="), SequenceSettings.MaxFramesInFlight);
+    FParse::Value(*Params, TEXT("Score="), Settings.ScoreThreshold);
+
+    if (SequenceSettings.Directory.IsEmpty())
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Sequence: -ImageDir= is required"));
+        return 1;
+    }
+
+    UNNEModelData* ModelData = LoadObject<UNNEModelData>(nullptr, *ModelPath);
+    UNeuralNetworkModel* Model = UNeuralNetworkModel::CreateModel(GetTransientPackage(), RuntimeName, ModelData);
+    if (!Model)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("Sequence: Could not create the model %s on %s"), *ModelPath, *RuntimeName);
+        return 1;
+    }
+    Model->AddToRoot();
+
+    FNeuralNetworkImageSequenceStats Stats;
+    const bool bSuccess = Model->DetectImageSequence(SequenceSettings, Settings, Stats);
+
+    UE_LOG(LogNeuralNetwork, Display, TEXT("Sequence: %d frames, %d failed, %d detections, %.1f frames/s"),
+        Stats.Frames, Stats.FailedFrames, Stats.Detections, Stats.FramesPerSecond);
+
+    Model->RemoveFromRoot();
+    return bSuccess ? 0 : 1;
+}
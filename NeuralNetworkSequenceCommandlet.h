@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "NeuralNetworkSequenceCommandlet.generated.h"
+
+
+/*
+ Offline detection over a recorded image sequence, detections are streamed to a JSON lines or CSV file:
+
+ UnrealEditor-Cmd <Project>.uproject -run=NeuralNetworkSequence -nullrhi -unattended
+     -ImageDir=<folder of PNG / JPEG frames> -Output=<file>.jsonl|.csv
+     [-Model=/Game/yolov8n] [-Runtime=Auto] [-BatchSize=8] [-InFlight=16] [-Score=0.25]
+*/
+UCLASS()
+class TUTORIAL_API UNeuralNetworkSequenceCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UNeuralNetworkSequenceCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkStats.h"
+
+DEFINE_LOG_CATEGORY(LogNeuralNetwork);
+
+DEFINE_STAT(STAT_NeuralNetwork_Preprocess);
+DEFINE_STAT(STAT_NeuralNetwork_Bind);
+DEFINE_STAT(STAT_NeuralNetwork_Run);
+DEFINE_STAT(STAT_NeuralNetwork_Postprocess);
+DEFINE_STAT(STAT_NeuralNetwork_Record);
+DEFINE_STAT(STAT_NeuralNetwork_Track);
+
+DEFINE_STAT(STAT_NeuralNetwork_Inferences);
+DEFINE_STAT(STAT_NeuralNetwork_Detections);
+DEFINE_STAT(STAT_NeuralNetwork_FramesDropped);
+DEFINE_STAT(STAT_NeuralNetwork_BudgetMisses);
+DEFINE_STAT(STAT_NeuralNetwork_InputSize);
+DEFINE_STAT(STAT_NeuralNetwork_TensorPoolMemory);
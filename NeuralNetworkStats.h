@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// Hot path messages are Verbose, enable them with "log LogNeuralNetwork Verbose"
+TUTORIAL_API DECLARE_LOG_CATEGORY_EXTERN(LogNeuralNetwork, Log, All);
+
+// "stat NeuralNetwork" shows the time spent per stage
+DECLARE_STATS_GROUP(TEXT("NeuralNetwork"), STATGROUP_NeuralNetwork, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Preprocess"), STAT_NeuralNetwork_Preprocess, STATGROUP_NeuralNetwork, TUTORIAL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bind"), STAT_NeuralNetwork_Bind, STATGROUP_NeuralNetwork, TUTORIAL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Run"), STAT_NeuralNetwork_Run, STATGROUP_NeuralNetwork, TUTORIAL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Postprocess"), STAT_NeuralNetwork_Postprocess, STATGROUP_NeuralNetwork, TUTORIAL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Record"), STAT_NeuralNetwork_Record, STATGROUP_NeuralNetwork, TUTORIAL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Track"), STAT_NeuralNetwork_Track, STATGROUP_NeuralNetwork, TUTORIAL_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Inferences"), STAT_NeuralNetwork_Inferences, STATGROUP_NeuralNetwork, TUTORIAL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Detections"), STAT_NeuralNetwork_Detections, STATGROUP_NeuralNetwork, TUTORIAL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Frames Dropped"), STAT_NeuralNetwork_FramesDropped, STATGROUP_NeuralNetwork, TUTORIAL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Budget Misses"), STAT_NeuralNetwork_BudgetMisses, STATGROUP_NeuralNetwork, TUTORIAL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Input Size"), STAT_NeuralNetwork_InputSize, STATGROUP_NeuralNetwork, TUTORIAL_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Tensor Pool Memory"), STAT_NeuralNetwork_TensorPoolMemory, STATGROUP_NeuralNetwork, TUTORIAL_API);
+
+// Cycle counter plus a named Unreal Insights scope for one pipeline stage
+#define NEURAL_NETWORK_SCOPE(Stage) \
+    TRACE_CPUPROFILER_EVENT_SCOPE(NeuralNetwork_##Stage); \
+    SCOPE_CYCLE_COUNTER(STAT_NeuralNetwork_##Stage)
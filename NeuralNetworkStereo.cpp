@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkStereo.h"
+#include "NeuralNetworkStats.h"
+
+#include "Async/ParallelFor.h"
+
+// ######################################################################################################################
+
+/*
+- Parameters:
+ 1) Left, Right: The eye views.
+ 2) TargetWidth, TargetHeight: Size of the combined input, each view gets TargetWidth / 2 x TargetHeight.
+ 3) OutTensor: Receives the 3 x TargetHeight x TargetWidth planar tensor.
+ 4) Scratch: Per view planar tensors, kept by the caller so repeated calls do not allocate.
+ 5) OutLetterboxes: Mapping of each view into its own half, PadX is relative to the start of the half.
+- What it does: Letterboxes the two views in parallel, then interleaves their rows into the combined tensor.
+- Return Value: bool indicating whether both views could be preprocessed.
+*/
+bool NeuralNetworkStereo::LetterboxSideBySide(const FNeuralNetworkImageView& Left, const FNeuralNetworkImageView& Right, int32 TargetWidth, int32 TargetHeight,
+    float* OutTensor, TArray<float> (&Scratch)[2], FNeuralNetworkLetterbox (&OutLetterboxes)[2])
+{
+    const int32 HalfWidth = TargetWidth / 2;
+    if (!OutTensor || HalfWidth < 1 || TargetHeight < 1)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("LetterboxSideBySide failed: Invalid target size %dx%d"), TargetWidth, TargetHeight);
+        return false;
+    }
+
+    const FNeuralNetworkImageView* Views[2] = { &Left, &Right };
+    bool bSuccess[2] = { false, false };
+    ParallelFor(2, [&](int32 View)
+    {
+        Scratch[View].SetNumUninitialized(3 * HalfWidth * TargetHeight, false);
+        bSuccess[View] = NeuralNetworkPreprocess::Letterbox(*Views[View], HalfWidth, TargetHeight, Scratch[View].GetData(), OutLetterboxes[View]);
+    });
+
+    if (!bSuccess[0] || !bSuccess[1])
+    {
+        return false;
+    }
+
+    NEURAL_NETWORK_SCOPE(Preprocess);
+
+    // An odd TargetWidth leaves one grey column at the right edge
+    ParallelFor(3 * TargetHeight, [&](int32 Row)
+    {
+        float* Out = OutTensor + static_cast<int64>(Row) * TargetWidth;
+        FMemory::Memcpy(Out, Scratch[0].GetData() + static_cast<int64>(Row) * HalfWidth, HalfWidth * sizeof(float));
+        FMemory::Memcpy(Out + HalfWidth, Scratch[1].GetData() + static_cast<int64>(Row) * HalfWidth, HalfWidth * sizeof(float));
+        for (int32 X = 2 * HalfWidth; X < TargetWidth; X++)
+        {
+            Out[X] = NeuralNetworkPreprocess::PadValue;
+        }
+    });
+
+    return true;
+}
+
+/*
+- Parameters:
+ 1) InOutDetections: Detections in pixels of the combined tensor, replaced by detections in source pixels.
+ 2) TargetWidth: Width of the combined tensor.
+ 3) Letterboxes: The mappings returned by LetterboxSideBySide.
+- What it does: Assigns every box to the half its center lies in, tags it with that view and undoes the view's
+  letterbox. Boxes that reach across the seam are clipped to their own view.
+- Return Value: None.
+*/
+void NeuralNetworkStereo::SplitSideBySide(TArray<FNeuralNetworkDetection>& InOutDetections, int32 TargetWidth, const FNeuralNetworkLetterbox (&Letterboxes)[2])
+{
+    const int32 HalfWidth = TargetWidth / 2;
+
+    for (FNeuralNetworkDetection& Detection : InOutDetections)
+    {
+        const int32 View = 0.5 * (Detection.Min.X + Detection.Max.X) < HalfWidth ? 0 : 1;
+        const FNeuralNetworkLetterbox& Letterbox = Letterboxes[View];
+
+        const FVector2D Offset(View * HalfWidth + Letterbox.PadX, Letterbox.PadY);
+        const double InvScale = 1.0 / Letterbox.Scale;
+        const FVector2D SourceMax(Letterbox.SourceWidth, Letterbox.SourceHeight);
+
+        Detection.Min = FVector2D::Max(FVector2D::ZeroVector, FVector2D::Min((Detection.Min - Offset) * InvScale, SourceMax));
+        Detection.Max = FVector2D::Max(FVector2D::ZeroVector, FVector2D::Min((Detection.Max - Offset) * InvScale, SourceMax));
+        Detection.ViewIndex = View;
+    }
+}
+
+/*
+- Parameters:
+ 1) InOutDetections: Detections of both views, tagged with their ViewIndex. Filtered in place, order is kept.
+ 2) Settings: Overlap and disparity limits.
+ 3) bClassAgnostic: Accept a counterpart of any class.
+ 4) ImageWidth: Width of the eye images in source pixels.
+- What it does: A real object shows up in both eyes at almost the same height and size, shifted sideways by the
+  disparity. A detection is kept if the other view has a box overlapping it vertically by at least
+  MinVerticalOverlap whose center is at most MaxDisparity of the image width away horizontally.
+- Return Value: None.
+*/
+void NeuralNetworkStereo::CrossEyeFilter(TArray<FNeuralNetworkDetection>& InOutDetections, const FNeuralNetworkStereoSettings& Settings, bool bClassAgnostic, int32 ImageWidth)
+{
+    NEURAL_NETWORK_SCOPE(Postprocess);
+
+    const double MaxShift = static_cast<double>(Settings.MaxDisparity) * ImageWidth;
+
+    TBitArray<> Keep(false, InOutDetections.Num());
+    for (int32 i = 0; i < InOutDetections.Num(); i++)
+    {
+        const FNeuralNetworkDetection& A = InOutDetections[i];
+        for (int32 j = 0; j < InOutDetections.Num(); j++)
+        {
+            const FNeuralNetworkDetection& B = InOutDetections[j];
+            if (B.ViewIndex == A.ViewIndex || (!bClassAgnostic && B.ClassId != A.ClassId))
+            {
+                continue;
+            }
+
+            const double Intersection = FMath::Min(A.Max.Y, B.Max.Y) - FMath::Max(A.Min.Y, B.Min.Y);
+            const double Union = FMath::Max(A.Max.Y, B.Max.Y) - FMath::Min(A.Min.Y, B.Min.Y);
+            const double Shift = FMath::Abs((A.Min.X + A.Max.X) - (B.Min.X + B.Max.X)) * 0.5;
+            if (Union > 0.0 && Intersection / Union >= Settings.MinVerticalOverlap && Shift <= MaxShift)
+            {
+                Keep[i] = true;
+                break;
+            }
+        }
+    }
+
+    int32 NumKept = 0;
+    for (int32 i = 0; i < InOutDetections.Num(); i++)
+    {
+        if (Keep[i])
+        {
+            InOutDetections[NumKept++] = InOutDetections[i];
+        }
+    }
+
+    UE_LOG(LogNeuralNetwork, Verbose, TEXT("CrossEyeFilter: Kept %d of %d detections"), NumKept, InOutDetections.Num());
+    InOutDetections.SetNum(NumKept, false);
+}
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkDetection.h"
+#include "NeuralNetworkPreprocess.h"
+
+#include "NeuralNetworkStereo.generated.h"
+
+
+// How the two eye views are fed to the network
+UENUM(BlueprintType, Category = "NNE - Tutorial")
+enum class ENeuralNetworkStereoLayout : uint8
+{
+    // Both views as a batch of 2, needs a model with a dynamic batch dimension
+    Batched,
+    // Both views letterboxed into the left and right half of one input, works with any model at half the resolution
+    SideBySide
+};
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkStereoSettings
+{
+    GENERATED_BODY()
+
+public:
+
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    ENeuralNetworkStereoLayout Layout = ENeuralNetworkStereoLayout::Batched;
+
+    // Drop detections that have no matching detection in the other eye
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    bool bCrossEyeFilter = true;
+
+    // Vertical overlap (intersection over union of the Y extents) a match in the other eye needs
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float MinVerticalOverlap = 0.5f;
+
+    // Largest horizontal shift between the two eyes, as a fraction of the image width
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float MaxDisparity = 0.15f;
+};
+
+namespace NeuralNetworkStereo
+{
+    // Letterboxes both views into the halves of a 3 x TargetHeight x TargetWidth tensor. Scratch holds one half per view.
+    TUTORIAL_API bool LetterboxSideBySide(const FNeuralNetworkImageView& Left, const FNeuralNetworkImageView& Right, int32 TargetWidth, int32 TargetHeight,
+        float* OutTensor, TArray<float> (&Scratch)[2], FNeuralNetworkLetterbox (&OutLetterboxes)[2]);
+
+    // Moves detections decoded in side-by-side tensor pixels into the source pixels of the view their center falls in
+    TUTORIAL_API void SplitSideBySide(TArray<FNeuralNetworkDetection>& InOutDetections, int32 TargetWidth, const FNeuralNetworkLetterbox (&Letterboxes)[2]);
+
+    // Keeps only the detections with a plausible counterpart of the same class in the other view
+    TUTORIAL_API void CrossEyeFilter(TArray<FNeuralNetworkDetection>& InOutDetections, const FNeuralNetworkStereoSettings& Settings, bool bClassAgnostic, int32 ImageWidth);
+}
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkTensorHandle.h"
+#include "NeuralNetworkStats.h"
+
+#include "Misc/ScopeLock.h"
+
+FNeuralNetworkImageView FNeuralNetworkImageStorage::GetView() const
+{
+    FNeuralNetworkImageView View;
+    View.Width = Width;
+    View.Height = Height;
+    if (Colors.Num() > 0)
+    {
+        View.Pixels = reinterpret_cast<const uint8*>(Colors.GetData());
+        View.RowStride = Width * sizeof(FColor);
+        View.Format = ENeuralNetworkPixelFormat::BGRA8;
+    }
+    else
+    {
+        View.Pixels = Pixels.GetData();
+        View.RowStride = Width * 4;
+        View.Format = Format;
+    }
+    return View;
+}
+
+// ######################################################################################################################
+
+FNeuralNetworkTensorRegistry& FNeuralNetworkTensorRegistry::Get()
+{
+    static FNeuralNetworkTensorRegistry Registry;
+    return Registry;
+}
+
+FNeuralNetworkTensorHandle FNeuralNetworkTensorRegistry::Add(TUniquePtr<FNeuralNetworkTensorStorage> Storage)
+{
+    FNeuralNetworkTensorHandle Handle;
+    if (Storage.IsValid())
+    {
+        FScopeLock ScopeLock(&Lock);
+        Handle.Id = NextId++;
+        Tensors.Add(Handle.Id, MoveTemp(Storage));
+    }
+    return Handle;
+}
+
+FNeuralNetworkImageHandle FNeuralNetworkTensorRegistry::Add(TUniquePtr<FNeuralNetworkImageStorage> Storage)
+{
+    FNeuralNetworkImageHandle Handle;
+    if (Storage.IsValid())
+    {
+        Handle.Width = Storage->Width;
+        Handle.Height = Storage->Height;
+
+        FScopeLock ScopeLock(&Lock);
+        Handle.Id = NextId++;
+        Images.Add(Handle.Id, MoveTemp(Storage));
+    }
+    return Handle;
+}
+
+FNeuralNetworkTensorStorage* FNeuralNetworkTensorRegistry::Find(const FNeuralNetworkTensorHandle& Handle)
+{
+    FScopeLock ScopeLock(&Lock);
+    TUniquePtr<FNeuralNetworkTensorStorage>* Storage = Tensors.Find(Handle.Id);
+    return Storage ? Storage->Get() : nullptr;
+}
+
+FNeuralNetworkImageStorage* FNeuralNetworkTensorRegistry::Find(const FNeuralNetworkImageHandle& Handle)
+{
+    FScopeLock ScopeLock(&Lock);
+    TUniquePtr<FNeuralNetworkImageStorage>* Storage = Images.Find(Handle.Id);
+    return Storage ? Storage->Get() : nullptr;
+}
+
+TUniquePtr<FNeuralNetworkTensorStorage> FNeuralNetworkTensorRegistry::Take(const FNeuralNetworkTensorHandle& Handle)
+{
+    TUniquePtr<FNeuralNetworkTensorStorage> Storage;
+    FScopeLock ScopeLock(&Lock);
+    Tensors.RemoveAndCopyValue(Handle.Id, Storage);
+    return Storage;
+}
+
+TUniquePtr<FNeuralNetworkImageStorage> FNeuralNetworkTensorRegistry::Take(const FNeuralNetworkImageHandle& Handle)
+{
+    TUniquePtr<FNeuralNetworkImageStorage> Storage;
+    FScopeLock ScopeLock(&Lock);
+    Images.RemoveAndCopyValue(Handle.Id, Storage);
+    return Storage;
+}
+
+bool FNeuralNetworkTensorRegistry::Release(const FNeuralNetworkTensorHandle& Handle)
+{
+    // Destroyed outside the lock, the buffer goes back to its pool
+    return Take(Handle).IsValid();
+}
+
+bool FNeuralNetworkTensorRegistry::Release(const FNeuralNetworkImageHandle& Handle)
+{
+    return Take(Handle).IsValid();
+}
+
+int32 FNeuralNetworkTensorRegistry::Num()
+{
+    FScopeLock ScopeLock(&Lock);
+    return Tensors.Num() + Images.Num();
+}
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkPreprocess.h"
+#include "NeuralNetworkTensorPool.h"
+
+#include "NeuralNetworkTensorHandle.generated.h"
+
+
+// Blueprint side of a natively owned float tensor. Copying the handle copies the ID, never the data.
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkTensorHandle
+{
+    GENERATED_BODY()
+
+public:
+
+    // 0 for no tensor
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 Id = 0;
+
+    bool IsValid() const { return Id != 0; }
+};
+
+// Blueprint side of a natively owned 8-bit image, e.g. a loaded PNG or a render target readback
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkImageHandle
+{
+    GENERATED_BODY()
+
+public:
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 Id = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 Width = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 Height = 0;
+
+    bool IsValid() const { return Id != 0; }
+};
+
+// Data behind a tensor handle, move-only since the buffer is
+struct FNeuralNetworkTensorStorage
+{
+    TArray<int32> Shape;
+    FNeuralNetworkTensorPool::FBuffer Buffer;
+
+    TArrayView<float> GetView() const { return Buffer.GetView(); }
+};
+
+// Data behind an image handle, Pixels for byte data (PNG decode) or Colors for FColor data (render target readback)
+struct FNeuralNetworkImageStorage
+{
+    TArray<uint8> Pixels;
+    TArray<FColor> Colors;
+    int32 Width = 0;
+    int32 Height = 0;
+    ENeuralNetworkPixelFormat Format = ENeuralNetworkPixelFormat::RGBA8;
+
+    FNeuralNetworkImageView GetView() const;
+};
+
+// Process wide owner of the data behind tensor and image handles. Blueprint only ever passes the IDs around, native
+// code reads and writes the data in place through Find, or takes it over with Take. Thread safe; a pointer returned by
+// Find stays valid until its handle is released or taken.
+class TUTORIAL_API FNeuralNetworkTensorRegistry
+{
+public:
+
+    static FNeuralNetworkTensorRegistry& Get();
+
+    FNeuralNetworkTensorHandle Add(TUniquePtr<FNeuralNetworkTensorStorage> Storage);
+    FNeuralNetworkImageHandle Add(TUniquePtr<FNeuralNetworkImageStorage> Storage);
+
+    FNeuralNetworkTensorStorage* Find(const FNeuralNetworkTensorHandle& Handle);
+    FNeuralNetworkImageStorage* Find(const FNeuralNetworkImageHandle& Handle);
+
+    // Removes the entry and hands its data to the caller, e.g. to move a frame to a worker thread
+    TUniquePtr<FNeuralNetworkTensorStorage> Take(const FNeuralNetworkTensorHandle& Handle);
+    TUniquePtr<FNeuralNetworkImageStorage> Take(const FNeuralNetworkImageHandle& Handle);
+
+    bool Release(const FNeuralNetworkTensorHandle& Handle);
+    bool Release(const FNeuralNetworkImageHandle& Handle);
+
+    // Live handles, a number that keeps growing means Blueprint forgets to release them
+    int32 Num();
+
+private:
+
+    FCriticalSection Lock;
+    TMap<int64, TUniquePtr<FNeuralNetworkTensorStorage>> Tensors;
+    TMap<int64, TUniquePtr<FNeuralNetworkImageStorage>> Images;
+    int64 NextId = 1;
+};
@@ -0,0 +1,378 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkTensorPool.h"
+#include "NeuralNetworkStats.h"
+
+#include "Misc/ScopeLock.h"
+
+#if PLATFORM_LINUX
+#include <sys/mman.h>
+#endif
+
+namespace NeuralNetworkTensorPool
+{
+    // Transparent huge page size on x86-64 and the common arm64 kernels
+    static constexpr SIZE_T HugePageSize = 2 * 1024 * 1024;
+}
+
+// ######################################################################################################################
+
+/*
+- Parameters:
+ 1) Settings: Huge page backing and how much released memory to keep.
+- What it does: Creates an empty pool, buffers are only allocated on demand.
+- Return Value: The pool.
+*/
+TSharedPtr<FNeuralNetworkTensorPool, ESPMode::ThreadSafe> FNeuralNetworkTensorPool::Create(const FNeuralNetworkTensorPoolSettings& Settings)
+{
+    TSharedPtr<FNeuralNetworkTensorPool, ESPMode::ThreadSafe> Pool = MakeShareable(new FNeuralNetworkTensorPool());
+    Pool->Settings = Settings;
+
+#if !PLATFORM_LINUX
+    if (Settings.bUseHugePages)
+    {
+        UE_LOG(LogNeuralNetwork, Log, TEXT("FNeuralNetworkTensorPool: Huge pages are only supported on Linux, using regular pages"));
+    }
+#endif
+
+    return Pool;
+}
+
+FNeuralNetworkTensorPool::~FNeuralNetworkTensorPool()
+{
+    // Outstanding buffers keep the pool alive, so only free memory is left here
+    Trim();
+}
+
+/*
+- Parameters:
+ 1) NumElements: Number of floats.
+- What it does: Hands out a released buffer of the same block size if there is one, otherwise allocates a new one.
+- Return Value: FBuffer, invalid if NumElements is not positive or the allocation failed.
+*/
+FNeuralNetworkTensorPool::FBuffer FNeuralNetworkTensorPool::Acquire(int32 NumElements)
+{
+    FBuffer Buffer;
+    if (NumElements < 1)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("FNeuralNetworkTensorPool::Acquire failed: Invalid size %d"), NumElements);
+        return Buffer;
+    }
+
+    const SIZE_T Bytes = GetBlockSize(NumElements, Settings.bUseHugePages);
+
+    {
+        FScopeLock ScopeLock(&Lock);
+        if (TArray<FBlock>* Blocks = FreeBlocks.Find(Bytes); Blocks && Blocks->Num() > 0)
+        {
+            const FBlock Block = Blocks->Pop(false);
+            Stats.Hits++;
+            Stats.BytesPooled -= Bytes;
+            Stats.BytesInUse += Bytes;
+
+            Buffer.Pool = AsShared();
+            Buffer.Data = Block.Data;
+            Buffer.NumElements = NumElements;
+            Buffer.Bytes = Bytes;
+            Buffer.bHugePages = Block.bHugePages;
+            return Buffer;
+        }
+    }
+
+    // Allocate outside the lock, a fresh multi-megabyte block can take a while to map
+    bool bHugePages = false;
+    float* Data = AllocateBlock(Bytes, Settings.bUseHugePages, bHugePages);
+    if (!Data)
+    {
+        UE_LOG(LogNeuralNetwork, Error, TEXT("FNeuralNetworkTensorPool::Acquire failed: Could not allocate %llu bytes"), static_cast<uint64>(Bytes));
+        return Buffer;
+    }
+
+    {
+        FScopeLock ScopeLock(&Lock);
+        Stats.Misses++;
+        Stats.BytesInUse += Bytes;
+        UpdateHighWater();
+    }
+
+    Buffer.Pool = AsShared();
+    Buffer.Data = Data;
+    Buffer.NumElements = NumElements;
+    Buffer.Bytes = Bytes;
+    Buffer.bHugePages = bHugePages;
+    return Buffer;
+}
+
+/*
+- Parameters:
+ 1) InOutBuffer: The buffer to resize, may be invalid.
+ 2) NumElements: Number of floats it has to hold.
+- What it does: Keeps the buffer when its block already has the size NumElements needs, otherwise trades it for a
+  pooled one. Meant for staging buffers that keep the same size from frame to frame.
+- Return Value: bool indicating whether InOutBuffer now holds NumElements floats.
+*/
+bool FNeuralNetworkTensorPool::Resize(FBuffer& InOutBuffer, int32 NumElements)
+{
+    if (InOutBuffer.IsValid() && InOutBuffer.Pool.Get() == this && InOutBuffer.Bytes == GetBlockSize(NumElements, Settings.bUseHugePages))
+    {
+        InOutBuffer.NumElements = NumElements;
+        return true;
+    }
+
+    InOutBuffer.Release();
+    InOutBuffer = Acquire(NumElements);
+    return InOutBuffer.IsValid();
+}
+
+/*
+- Parameters:
+ 1) NumElements: Number of floats.
+ 2) OutData: Replaced by recycled storage holding NumElements uninitialized floats.
+- What it does: The Blueprint counterpart of Acquire. FNeuralNetworkTensor owns a TArray, so instead of pointing at
+  a pooled block its storage is moved in and out of the pool, which costs no copy either way.
+- Return Value: None.
+*/
+void FNeuralNetworkTensorPool::AcquireArray(int32 NumElements, TArray<float>& OutData)
+{
+    ReleaseArray(OutData);
+    if (NumElements < 1)
+    {
+        return;
+    }
+
+    {
+        FScopeLock ScopeLock(&Lock);
+        if (TArray<TArray<float>>* Arrays = FreeArrays.Find(NumElements); Arrays && Arrays->Num() > 0)
+        {
+            OutData = Arrays->Pop(false);
+            const int64 Bytes = OutData.GetAllocatedSize();
+            Stats.Hits++;
+            Stats.BytesPooled -= Bytes;
+            Stats.BytesInUse += Bytes;
+            return;
+        }
+    }
+
+    OutData.SetNumUninitialized(NumElements);
+
+    FScopeLock ScopeLock(&Lock);
+    Stats.Misses++;
+    Stats.BytesInUse += OutData.GetAllocatedSize();
+    UpdateHighWater();
+}
+
+/*
+- Parameters:
+ 1) InOutData: Storage obtained from AcquireArray, left empty.
+- What it does: Takes the storage back for the next AcquireArray of the same size, or frees it when the pool is full.
+  Arrays that did not come from AcquireArray are accepted too and simply join the pool.
+- Return Value: None.
+*/
+void FNeuralNetworkTensorPool::ReleaseArray(TArray<float>& InOutData)
+{
+    if (InOutData.Num() == 0)
+    {
+        InOutData.Empty();
+        return;
+    }
+
+    const int64 Bytes = InOutData.GetAllocatedSize();
+
+    FScopeLock ScopeLock(&Lock);
+    Stats.BytesInUse = FMath::Max<int64>(0, Stats.BytesInUse - Bytes);
+    if (CanKeep(Bytes))
+    {
+        Stats.BytesPooled += Bytes;
+        FreeArrays.FindOrAdd(InOutData.Num()).Add(MoveTemp(InOutData));
+        UpdateHighWater();
+    }
+    InOutData.Empty();
+}
+
+/*
+- Parameters: None.
+- What it does: Frees every pooled buffer. Buffers in use are not affected and return to the pool as usual.
+- Return Value: None.
+*/
+void FNeuralNetworkTensorPool::Trim()
+{
+    TMap<SIZE_T, TArray<FBlock>> Blocks;
+    TMap<int32, TArray<TArray<float>>> Arrays;
+    {
+        FScopeLock ScopeLock(&Lock);
+        Blocks = MoveTemp(FreeBlocks);
+        Arrays = MoveTemp(FreeArrays);
+        FreeBlocks.Reset();
+        FreeArrays.Reset();
+        Stats.BytesPooled = 0;
+    }
+
+    for (const TPair<SIZE_T, TArray<FBlock>>& Pair : Blocks)
+    {
+        for (const FBlock& Block : Pair.Value)
+        {
+            FreeBlock(Block.Data, Pair.Key, Block.bHugePages);
+        }
+    }
+}
+
+FNeuralNetworkTensorPoolStats FNeuralNetworkTensorPool::GetStats() const
+{
+    FScopeLock ScopeLock(&Lock);
+    return Stats;
+}
+
+void FNeuralNetworkTensorPool::ReleaseBlock(float* Data, SIZE_T Bytes, bool bHugePages)
+{
+    {
+        FScopeLock ScopeLock(&Lock);
+        Stats.BytesInUse -= Bytes;
+        if (CanKeep(Bytes))
+        {
+            Stats.BytesPooled += Bytes;
+            FreeBlocks.FindOrAdd(Bytes).Add(FBlock{ Data, bHugePages });
+            return;
+        }
+    }
+
+    FreeBlock(Data, Bytes, bHugePages);
+}
+
+bool FNeuralNetworkTensorPool::CanKeep(SIZE_T Bytes) const
+{
+    const int64 MaxPooledBytes = static_cast<int64>(FMath::Max(0, Settings.MaxPooledMegabytes)) * 1024 * 1024;
+    return Stats.BytesPooled + static_cast<int64>(Bytes) <= MaxPooledBytes;
+}
+
+void FNeuralNetworkTensorPool::UpdateHighWater()
+{
+    Stats.HighWaterBytes = FMath::Max(Stats.HighWaterBytes, Stats.BytesInUse + Stats.BytesPooled);
+}
+
+/*
+- Parameters:
+ 1) NumElements: Number of floats.
+ 2) bHugePages: Whether large blocks are backed by huge pages.
+- What it does: Rounds the size up to the alignment, or to whole huge pages for blocks that get them, so sizes that
+  only differ by the rounding share one free list.
+- Return Value: SIZE_T block size in bytes.
+*/
+SIZE_T FNeuralNetworkTensorPool::GetBlockSize(int32 NumElements, bool bHugePages)
+{
+    const SIZE_T Bytes = Align(static_cast<SIZE_T>(FMath::Max(NumElements, 1)) * sizeof(float), Alignment);
+#if PLATFORM_LINUX
+    if (bHugePages && Bytes >= NeuralNetworkTensorPool::HugePageSize)
+    {
+        return Align(Bytes, NeuralNetworkTensorPool::HugePageSize);
+    }
+#endif
+    return Bytes;
+}
+
+float* FNeuralNetworkTensorPool::AllocateBlock(SIZE_T Bytes, bool bHugePages, bool& bOutHugePages)
+{
+    bOutHugePages = false;
+
+#if PLATFORM_LINUX
+    using NeuralNetworkTensorPool::HugePageSize;
+    if (bHugePages && Bytes >= HugePageSize)
+    {
+        // Over-map by one huge page and cut off the ends, so the block starts on a huge page boundary and every page
+        // of it can be collapsed
+        const SIZE_T MappedBytes = Bytes + HugePageSize;
+        void* Mapped = mmap(nullptr, MappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (Mapped != MAP_FAILED)
+        {
+            uint8* Base = static_cast<uint8*>(Mapped);
+            uint8* Block = Align(Base, HugePageSize);
+            if (Block > Base)
+            {
+                munmap(Base, Block - Base);
+            }
+            if (Base + MappedBytes > Block + Bytes)
+            {
+                munmap(Block + Bytes, (Base + MappedBytes) - (Block + Bytes));
+            }
+
+            // Only a hint, with THP disabled the block is still valid memory on regular pages
+            madvise(Block, Bytes, MADV_HUGEPAGE);
+
+            INC_MEMORY_STAT_BY(STAT_NeuralNetwork_TensorPoolMemory, Bytes);
+            bOutHugePages = true;
+            return reinterpret_cast<float*>(Block);
+        }
+        UE_LOG(LogNeuralNetwork, Warning, TEXT("FNeuralNetworkTensorPool: mmap of %llu bytes failed, using regular pages"), static_cast<uint64>(Bytes));
+    }
+#endif
+
+    float* Data = static_cast<float*>(FMemory::Malloc(Bytes, Alignment));
+    if (Data)
+    {
+        INC_MEMORY_STAT_BY(STAT_NeuralNetwork_TensorPoolMemory, Bytes);
+    }
+    return Data;
+}
+
+void FNeuralNetworkTensorPool::FreeBlock(float* Data, SIZE_T Bytes, bool bHugePages)
+{
+    DEC_MEMORY_STAT_BY(STAT_NeuralNetwork_TensorPoolMemory, Bytes);
+
+#if PLATFORM_LINUX
+    if (bHugePages)
+    {
+        munmap(Data, Bytes);
+        return;
+    }
+#endif
+
+    FMemory::Free(Data);
+}
+
+// ######################################################################################################################
+
+FNeuralNetworkTensorPool::FBuffer::FBuffer(FBuffer&& Other)
+    : Pool(MoveTemp(Other.Pool))
+    , Data(Other.Data)
+    , NumElements(Other.NumElements)
+    , Bytes(Other.Bytes)
+    , bHugePages(Other.bHugePages)
+{
+    Other.Data = nullptr;
+    Other.NumElements = 0;
+    Other.Bytes = 0;
+}
+
+FNeuralNetworkTensorPool::FBuffer& FNeuralNetworkTensorPool::FBuffer::operator=(FBuffer&& Other)
+{
+    if (this != &Other)
+    {
+        Release();
+        Pool = MoveTemp(Other.Pool);
+        Data = Other.Data;
+        NumElements = Other.NumElements;
+        Bytes = Other.Bytes;
+        bHugePages = Other.bHugePages;
+        Other.Data = nullptr;
+        Other.NumElements = 0;
+        Other.Bytes = 0;
+    }
+    return *this;
+}
+
+FNeuralNetworkTensorPool::FBuffer::~FBuffer()
+{
+    Release();
+}
+
+void FNeuralNetworkTensorPool::FBuffer::Release()
+{
+    if (Data && Pool.IsValid())
+    {
+        Pool->ReleaseBlock(Data, Bytes, bHugePages);
+    }
+    Pool.Reset();
+    Data = nullptr;
+    NumElements = 0;
+    Bytes = 0;
+}
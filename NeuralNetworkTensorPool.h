@@ -0,0 +1,138 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkTensorPool.generated.h"
+
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkTensorPoolSettings
+{
+    GENERATED_BODY()
+
+public:
+
+    // Back buffers of 2 MB and more with transparent huge pages (Linux only, ignored elsewhere), fewer TLB misses
+    // when preprocessing and inference stream through multi-megabyte tensors
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    bool bUseHugePages = false;
+
+    // Released buffers are kept for reuse up to this much memory, the rest is freed right away. 0 keeps nothing.
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 MaxPooledMegabytes = 256;
+};
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkTensorPoolStats
+{
+    GENERATED_BODY()
+
+public:
+
+    // Acquires served from a released buffer of the same size
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 Hits = 0;
+
+    // Acquires that had to allocate
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 Misses = 0;
+
+    // Memory handed out and not yet released
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 BytesInUse = 0;
+
+    // Memory of released buffers waiting to be reused
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 BytesPooled = 0;
+
+    // Highest BytesInUse + BytesPooled seen, what the pool has cost at its worst
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 HighWaterBytes = 0;
+};
+
+// Recycles tensor memory so per frame tensors do not go through the allocator every frame. Native buffers are 64 byte
+// aligned and optionally backed by huge pages; Blueprint tensors recycle their TArray storage. Both are keyed by size,
+// so tensors of the same shape keep trading the same few buffers. Thread safe.
+class TUTORIAL_API FNeuralNetworkTensorPool : public TSharedFromThis<FNeuralNetworkTensorPool, ESPMode::ThreadSafe>
+{
+public:
+
+    static constexpr SIZE_T Alignment = 64;
+
+    // Exclusive use of one pooled float buffer, handed back to the pool when destroyed
+    class TUTORIAL_API FBuffer
+    {
+    public:
+        FBuffer() = default;
+        FBuffer(FBuffer&& Other);
+        FBuffer& operator=(FBuffer&& Other);
+        FBuffer(const FBuffer&) = delete;
+        FBuffer& operator=(const FBuffer&) = delete;
+        ~FBuffer();
+
+        bool IsValid() const { return Data != nullptr; }
+        float* GetData() const { return Data; }
+        int32 Num() const { return NumElements; }
+        TArrayView<float> GetView() const { return TArrayView<float>(Data, NumElements); }
+        operator TConstArrayView<float>() const { return TConstArrayView<float>(Data, NumElements); }
+
+        void Release();
+
+    private:
+        friend class FNeuralNetworkTensorPool;
+
+        TSharedPtr<FNeuralNetworkTensorPool, ESPMode::ThreadSafe> Pool;
+        float* Data = nullptr;
+        int32 NumElements = 0;
+        SIZE_T Bytes = 0;
+        bool bHugePages = false;
+    };
+
+    static TSharedPtr<FNeuralNetworkTensorPool, ESPMode::ThreadSafe> Create(const FNeuralNetworkTensorPoolSettings& Settings);
+
+    ~FNeuralNetworkTensorPool();
+
+    // Uninitialized buffer of NumElements floats, invalid if the memory could not be allocated
+    FBuffer Acquire(int32 NumElements);
+
+    // Makes InOutBuffer hold exactly NumElements floats, keeping its memory when the size is unchanged.
+    // The contents are not preserved.
+    bool Resize(FBuffer& InOutBuffer, int32 NumElements);
+
+    // Blueprint side: fills OutData with NumElements uninitialized floats from recycled storage, ReleaseArray takes it back
+    void AcquireArray(int32 NumElements, TArray<float>& OutData);
+    void ReleaseArray(TArray<float>& InOutData);
+
+    // Frees every buffer that is not in use
+    void Trim();
+
+    FNeuralNetworkTensorPoolStats GetStats() const;
+    const FNeuralNetworkTensorPoolSettings& GetSettings() const { return Settings; }
+
+private:
+
+    struct FBlock
+    {
+        float* Data = nullptr;
+        bool bHugePages = false;
+    };
+
+    FNeuralNetworkTensorPool() = default;
+
+    void ReleaseBlock(float* Data, SIZE_T Bytes, bool bHugePages);
+    bool CanKeep(SIZE_T Bytes) const;
+    void UpdateHighWater();
+
+    static float* AllocateBlock(SIZE_T Bytes, bool bHugePages, bool& bOutHugePages);
+    static void FreeBlock(float* Data, SIZE_T Bytes, bool bHugePages);
+    static SIZE_T GetBlockSize(int32 NumElements, bool bHugePages);
+
+    FNeuralNetworkTensorPoolSettings Settings;
+
+    mutable FCriticalSection Lock;
+    TMap<SIZE_T, TArray<FBlock>> FreeBlocks;
+    TMap<int32, TArray<TArray<float>>> FreeArrays;
+    FNeuralNetworkTensorPoolStats Stats;
+};
@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkTiling.h"
+#include "NeuralNetworkStats.h"
+
+#include "Async/ParallelFor.h"
+
+#include <atomic>
+
+namespace NeuralNetworkTiling
+{
+    // Start positions of Count tiles of Size spread evenly over Length, the first at 0 and the last flush with the end
+    static void LayoutAxis(int32 Length, int32 Size, int32 Count, TArray<int32, TInlineAllocator<16>>& OutStarts)
+    {
+        OutStarts.Reset();
+        if (Count <= 1 || Length <= Size)
+        {
+            OutStarts.Add(0);
+            return;
+        }
+
+        for (int32 i = 0; i < Count; i++)
+        {
+            OutStarts.Add(FMath::RoundToInt32(static_cast<double>(i) * (Length - Size) / (Count - 1)));
+        }
+    }
+
+    static int32 TilesAlongAxis(int32 Length, int32 Size, float Overlap)
+    {
+        if (Length <= Size)
+        {
+            return 1;
+        }
+        const double OverlapPixels = Size * FMath::Clamp(Overlap, 0.0f, 0.9f);
+        return FMath::CeilToInt32((Length - OverlapPixels) / (Size - OverlapPixels));
+    }
+}
+
+// ######################################################################################################################
+
+/*
+- Parameters:
+ 1) Width, Height: Size of the source frame.
+ 2) Settings: Tile size, overlap and tile limit.
+ 3) OutTiles: Receives the tile rectangles in source pixels.
+- What it does: Picks the number of tiles per axis so neighbours overlap by at least Settings.Overlap, then spreads
+  them evenly so the outer tiles touch the frame edges. Tiles are never larger than the frame. If the frame would
+  need more than MaxTiles tiles the tile size is increased until it fits.
+- Return Value: None.
+*/
+void NeuralNetworkTiling::ComputeTiles(int32 Width, int32 Height, const FNeuralNetworkTilingSettings& Settings, TArray<FIntRect>& OutTiles)
+{
+    OutTiles.Reset();
+    if (Width < 1 || Height < 1)
+    {
+        return;
+    }
+
+    const int32 MaxTiles = FMath::Max(1, Settings.MaxTiles);
+    int32 TileSize = FMath::Max(32, Settings.TileSize);
+    int32 CountX = TilesAlongAxis(Width, TileSize, Settings.Overlap);
+    int32 CountY = TilesAlongAxis(Height, TileSize, Settings.Overlap);
+    while (CountX * CountY > MaxTiles)
+    {
+        TileSize += TileSize / 4;
+        CountX = TilesAlongAxis(Width, TileSize, Settings.Overlap);
+        CountY = TilesAlongAxis(Height, TileSize, Settings.Overlap);
+    }
+
+    const int32 TileWidth = FMath::Min(TileSize, Width);
+    const int32 TileHeight = FMath::Min(TileSize, Height);
+
+    TArray<int32, TInlineAllocator<16>> StartsX, StartsY;
+    LayoutAxis(Width, TileWidth, CountX, StartsX);
+    LayoutAxis(Height, TileHeight, CountY, StartsY);
+
+    for (int32 Y : StartsY)
+    {
+        for (int32 X : StartsX)
+        {
+            OutTiles.Add(FIntRect(X, Y, X + TileWidth, Y + TileHeight));
+        }
+    }
+}
+
+FNeuralNetworkImageView NeuralNetworkTiling::Crop(const FNeuralNetworkImageView& Image, const FIntRect& Tile)
+{
+    const int32 RowStride = Image.RowStride > 0 ? Image.RowStride : Image.Width * 4;
+
+    FNeuralNetworkImageView View = Image;
+    View.Pixels = Image.Pixels + static_cast<int64>(Tile.Min.Y) * RowStride + Tile.Min.X * 4;
+    View.Width = Tile.Width();
+    View.Height = Tile.Height();
+    View.RowStride = RowStride;
+    return View;
+}
+
+/*
+- Parameters:
+ 1) Image: The full resolution source frame.
+ 2) Tiles: Rectangles of Image to preprocess, e.g. from ComputeTiles.
+ 3) TargetWidth, TargetHeight: Size of the model input.
+ 4) OutBatch: Receives Tiles.Num() planar tensors back to back.
+ 5) OutLetterboxes: Receives the mapping of each tile, relative to the tile's own origin.
+- What it does: Runs one letterbox per tile on the task graph. Each letterbox splits its rows again, so a few large
+  tiles still use every worker.
+- Return Value: bool indicating whether every tile could be preprocessed.
+*/
+bool NeuralNetworkTiling::PreprocessTiles(const FNeuralNetworkImageView& Image, TConstArrayView<FIntRect> Tiles, int32 TargetWidth, int32 TargetHeight,
+    float* OutBatch, TArray<FNeuralNetworkLetterbox>& OutLetterboxes)
+{
+    const int64 TileVolume = 3ll * TargetWidth * TargetHeight;
+    OutLetterboxes.SetNum(Tiles.Num());
+
+    std::atomic<int32> NumFailed{0};
+    ParallelFor(Tiles.Num(), [&](int32 TileIndex)
+    {
+        if (!NeuralNetworkPreprocess::Letterbox(Crop(Image, Tiles[TileIndex]), TargetWidth, TargetHeight, OutBatch + TileIndex * TileVolume, OutLetterboxes[TileIndex]))
+        {
+            NumFailed++;
+        }
+    });
+
+    return NumFailed == 0;
+}
+
+void NeuralNetworkTiling::OffsetDetections(TArray<FNeuralNetworkDetection>& InOutDetections, const FIntRect& Tile)
+{
+    const FVector2D Origin(Tile.Min.X, Tile.Min.Y);
+    for (FNeuralNetworkDetection& Detection : InOutDetections)
+    {
+        Detection.Min += Origin;
+        Detection.Max += Origin;
+    }
+}
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkDetection.h"
+#include "NeuralNetworkPreprocess.h"
+
+#include "NeuralNetworkTiling.generated.h"
+
+
+// How the tiles of one frame are run
+UENUM(BlueprintType, Category = "NNE - Tutorial")
+enum class ENeuralNetworkTileExecution : uint8
+{
+    // All tiles as one batch on the model instance, needs a model with a dynamic batch dimension
+    Batched,
+    // One tile per pooled instance in parallel, needs CreateInstancePool
+    Pooled
+};
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkTilingSettings
+{
+    GENERATED_BODY()
+
+public:
+
+    // Side of a square tile in source pixels. Tiles equal to the model input size are run without any scaling.
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 TileSize = 640;
+
+    // Fraction of a tile shared with its neighbour, objects cut by one tile border are whole in the next tile
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float Overlap = 0.2f;
+
+    // Also run the whole frame letterboxed as one extra tile, so objects larger than a tile are still found
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    bool bIncludeFullFrame = true;
+
+    // Upper bound of tiles per frame, the tile size grows when the frame would need more
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 MaxTiles = 16;
+
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    ENeuralNetworkTileExecution Execution = ENeuralNetworkTileExecution::Batched;
+};
+
+namespace NeuralNetworkTiling
+{
+    // Splits a Width x Height frame into overlapping tiles covering it, in source pixels, row by row
+    TUTORIAL_API void ComputeTiles(int32 Width, int32 Height, const FNeuralNetworkTilingSettings& Settings, TArray<FIntRect>& OutTiles);
+
+    // View of the pixels of one tile of Image, no copy
+    TUTORIAL_API FNeuralNetworkImageView Crop(const FNeuralNetworkImageView& Image, const FIntRect& Tile);
+
+    // Letterboxes every tile into its own 3 x TargetHeight x TargetWidth slice of OutBatch, tiles run in parallel
+    TUTORIAL_API bool PreprocessTiles(const FNeuralNetworkImageView& Image, TConstArrayView<FIntRect> Tiles, int32 TargetWidth, int32 TargetHeight,
+        float* OutBatch, TArray<FNeuralNetworkLetterbox>& OutLetterboxes);
+
+    // Moves detections decoded in tile pixels to source pixels
+    TUTORIAL_API void OffsetDetections(TArray<FNeuralNetworkDetection>& InOutDetections, const FIntRect& Tile);
+}
@@ -0,0 +1,422 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NeuralNetworkTracker.h"
+#include "NeuralNetworkStats.h"
+
+#include "Async/ParallelFor.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+    #include <arm_neon.h>
+    #define NN_TRACKER_NEON 1
+#else
+    #define NN_TRACKER_NEON 0
+#endif
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+    #include <emmintrin.h>
+    #define NN_TRACKER_SSE 1
+#else
+    #define NN_TRACKER_SSE 0
+#endif
+
+namespace NeuralNetworkTracker
+{
+    // Block matching compares PatchSize x PatchSize grey pixels, one SIMD register per row
+    static constexpr int32 PatchSize = 16;
+
+    // Patches whose grey values span less than this are flat, every offset would match them equally well
+    static constexpr int32 MinPatchContrast = 8;
+
+    // Sum of absolute differences of two PatchSize x PatchSize patches with the same row stride
+    static uint32 PatchSad(const uint8* A, const uint8* B, int32 Stride)
+    {
+#if NN_TRACKER_SSE
+        __m128i Sum = _mm_setzero_si128();
+        for (int32 y = 0; y < PatchSize; y++)
+        {
+            const __m128i RowA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(A + y * Stride));
+            const __m128i RowB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(B + y * Stride));
+            Sum = _mm_add_epi64(Sum, _mm_sad_epu8(RowA, RowB));
+        }
+        alignas(16) uint64 Lanes[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(Lanes), Sum);
+        return static_cast<uint32>(Lanes[0] + Lanes[1]);
+#elif NN_TRACKER_NEON
+        // 16 rows of two differences per lane stay below 2^16
+        uint16x8_t Sum = vdupq_n_u16(0);
+        for (int32 y = 0; y < PatchSize; y++)
+        {
+            const uint8x16_t RowA = vld1q_u8(A + y * Stride);
+            const uint8x16_t RowB = vld1q_u8(B + y * Stride);
+            Sum = vabal_u8(Sum, vget_low_u8(RowA), vget_low_u8(RowB));
+            Sum = vabal_high_u8(Sum, RowA, RowB);
+        }
+        return vaddlvq_u16(Sum);
+#else
+        uint32 Sum = 0;
+        for (int32 y = 0; y < PatchSize; y++)
+        {
+            for (int32 x = 0; x < PatchSize; x++)
+            {
+                Sum += FMath::Abs(static_cast<int32>(A[y * Stride + x]) - static_cast<int32>(B[y * Stride + x]));
+            }
+        }
+        return Sum;
+#endif
+    }
+
+    static FVector2D Center(const FNeuralNetworkDetection& Box)
+    {
+        return 0.5 * (Box.Min + Box.Max);
+    }
+}
+
+// ######################################################################################################################
+
+FNeuralNetworkTracker::FNeuralNetworkTracker(const FNeuralNetworkTrackerSettings& InSettings)
+    : Settings(InSettings)
+{
+    Settings.DetectInterval = FMath::Max(1, Settings.DetectInterval);
+    Settings.ConfidenceDecay = FMath::Clamp(Settings.ConfidenceDecay, 0.0f, 1.0f);
+    Settings.MaxMissedDetections = FMath::Max(0, Settings.MaxMissedDetections);
+    Settings.VelocitySmoothing = FMath::Clamp(Settings.VelocitySmoothing, 0.0f, 1.0f);
+    Settings.FlowDownsample = FMath::Clamp(Settings.FlowDownsample, 1, 16);
+    Settings.FlowSearchRadius = FMath::Clamp(Settings.FlowSearchRadius, 1, 32);
+}
+
+/*
+- Parameters:
+ 1) Image: The incoming frame.
+- What it does: Moves every track by its velocity, or by the block matched motion of its center patch when flow
+  refinement is on and the match is good, and decays its confidence. Tracks that left the frame are dropped. Then
+  decides whether the detector runs: on the first frame, after a size change, every DetectInterval frames and as soon
+  as a track is no longer trusted.
+- Return Value: bool, true when the detector has to run on this frame and its result be passed to Correct.
+*/
+bool FNeuralNetworkTracker::BeginFrame(const FNeuralNetworkImageView& Image)
+{
+    using namespace NeuralNetworkTracker;
+
+    NEURAL_NETWORK_SCOPE(Track);
+
+    Stats.Frames++;
+
+    if (FrameSize != FIntPoint(Image.Width, Image.Height))
+    {
+        Reset();
+        FrameSize = FIntPoint(Image.Width, Image.Height);
+    }
+
+    if (Settings.bUseFlowRefinement)
+    {
+        Swap(PreviousGrey, CurrentGrey);
+        GreySize = FIntPoint(Image.Width / Settings.FlowDownsample, Image.Height / Settings.FlowDownsample);
+        ComputeGrey(Image, CurrentGrey);
+    }
+
+    // Matching only reads the two grey frames, so the tracks are matched in parallel and moved afterwards
+    TArray<FVector2D, TInlineAllocator<64>> FlowMotions;
+    TArray<bool, TInlineAllocator<64>> FlowMatched;
+    FlowMotions.SetNumZeroed(Tracks.Num());
+    FlowMatched.SetNumZeroed(Tracks.Num());
+    // No previous frame to match against yet, e.g. right after a Reset
+    const bool bFlowAttempted = Settings.bUseFlowRefinement && PreviousGrey.Num() == CurrentGrey.Num() && CurrentGrey.Num() > 0;
+    if (bFlowAttempted)
+    {
+        ParallelFor(Tracks.Num(), [&](int32 i)
+        {
+            FlowMatched[i] = MatchFlow(Tracks[i], FlowMotions[i]);
+        }, Tracks.Num() < 4);
+    }
+
+    const FVector2D FrameMax(FrameSize.X, FrameSize.Y);
+    for (int32 i = Tracks.Num() - 1; i >= 0; i--)
+    {
+        FTrack& Track = Tracks[i];
+
+        FVector2D Motion = Track.Velocity;
+        if (FlowMatched[i])
+        {
+            Motion = FlowMotions[i];
+            Track.Velocity = FMath::Lerp(Track.Velocity, Motion, static_cast<double>(Settings.VelocitySmoothing));
+        }
+        else if (bFlowAttempted)
+        {
+            Track.Confidence *= Settings.ConfidenceDecay;
+            Stats.FlowRejected++;
+        }
+
+        Track.Box.Min += Motion;
+        Track.Box.Max += Motion;
+        Track.FramesSinceMeasured++;
+        Track.Confidence *= Settings.ConfidenceDecay;
+
+        const bool bInFrame = Track.Box.Max.X > 0.0 && Track.Box.Max.Y > 0.0 && Track.Box.Min.X < FrameMax.X && Track.Box.Min.Y < FrameMax.Y;
+        if (!bInFrame)
+        {
+            Tracks.RemoveAtSwap(i, 1, false);
+        }
+    }
+
+    FramesSinceDetection++;
+    bool bDetect = bForceDetection || FramesSinceDetection >= Settings.DetectInterval;
+    for (const FTrack& Track : Tracks)
+    {
+        bDetect |= Track.Confidence < Settings.MinTrackConfidence;
+    }
+
+    if (bDetect)
+    {
+        Stats.DetectorFrames++;
+        FramesSinceDetection = 0;
+        bForceDetection = false;
+    }
+
+    Stats.DetectorRatio = static_cast<float>(static_cast<double>(Stats.DetectorFrames) / Stats.Frames);
+    Stats.ActiveTracks = Tracks.Num();
+    return bDetect;
+}
+
+/*
+- Parameters:
+ 1) Detections: The detector output for the frame passed to the last BeginFrame.
+- What it does: Greedy association, highest IoU first, between the predicted tracks and the detections of the same
+  class. A matched track snaps to its detection and folds the motion since its last match into its velocity.
+  Unmatched tracks count a miss and are dropped after MaxMissedDetections, unmatched detections start new tracks.
+- Return Value: None.
+*/
+void FNeuralNetworkTracker::Correct(const TArray<FNeuralNetworkDetection>& Detections)
+{
+    using namespace NeuralNetworkTracker;
+
+    NEURAL_NETWORK_SCOPE(Track);
+
+    struct FPair
+    {
+        float Iou;
+        int32 TrackIndex;
+        int32 DetectionIndex;
+    };
+
+    TArray<FPair, TInlineAllocator<64>> Pairs;
+    for (int32 t = 0; t < Tracks.Num(); t++)
+    {
+        for (int32 d = 0; d < Detections.Num(); d++)
+        {
+            if (Tracks[t].Box.ClassId != Detections[d].ClassId || Tracks[t].Box.ViewIndex != Detections[d].ViewIndex)
+            {
+                continue;
+            }
+            const float Iou = NeuralNetworkDetection::IntersectionOverUnion(Tracks[t].Box, Detections[d]);
+            if (Iou > Settings.MatchIouThreshold)
+            {
+                Pairs.Add({ Iou, t, d });
+            }
+        }
+    }
+    Pairs.Sort([](const FPair& A, const FPair& B)
+    {
+        return A.Iou > B.Iou;
+    });
+
+    TBitArray<> TrackMatched(false, Tracks.Num());
+    TBitArray<> DetectionMatched(false, Detections.Num());
+    for (const FPair& Pair : Pairs)
+    {
+        if (TrackMatched[Pair.TrackIndex] || DetectionMatched[Pair.DetectionIndex])
+        {
+            continue;
+        }
+        TrackMatched[Pair.TrackIndex] = true;
+        DetectionMatched[Pair.DetectionIndex] = true;
+
+        FTrack& Track = Tracks[Pair.TrackIndex];
+        const FNeuralNetworkDetection& Detection = Detections[Pair.DetectionIndex];
+        const FVector2D NewCenter = Center(Detection);
+        const FVector2D Measured = (NewCenter - Track.MeasuredCenter) / FMath::Max(1, Track.FramesSinceMeasured);
+
+        // The first measurement has nothing to be smoothed against
+        Track.Velocity = Track.Hits == 1 ? Measured : FMath::Lerp(Track.Velocity, Measured, static_cast<double>(Settings.VelocitySmoothing));
+
+        const int32 TrackId = Track.Box.TrackId;
+        Track.Box = Detection;
+        Track.Box.TrackId = TrackId;
+        Track.MeasuredCenter = NewCenter;
+        Track.FramesSinceMeasured = 0;
+        Track.Confidence = Detection.Score;
+        Track.Hits++;
+        Track.Missed = 0;
+    }
+
+    for (int32 t = Tracks.Num() - 1; t >= 0; t--)
+    {
+        if (!TrackMatched[t] && ++Tracks[t].Missed > Settings.MaxMissedDetections)
+        {
+            Tracks.RemoveAt(t, 1, false);
+        }
+    }
+
+    for (int32 d = 0; d < Detections.Num(); d++)
+    {
+        if (DetectionMatched[d])
+        {
+            continue;
+        }
+
+        FTrack& Track = Tracks.AddDefaulted_GetRef();
+        Track.Box = Detections[d];
+        Track.Box.TrackId = NextTrackId++;
+        Track.MeasuredCenter = Center(Track.Box);
+        Track.Confidence = Track.Box.Score;
+        Track.Hits = 1;
+        Stats.TracksCreated++;
+    }
+
+    Stats.ActiveTracks = Tracks.Num();
+}
+
+/*
+- Parameters:
+ 1) OutDetections: Receives one detection per track, highest confidence first.
+- What it does: Returns the tracks in the current frame, Score holding the decayed track confidence.
+- Return Value: None.
+*/
+void FNeuralNetworkTracker::GetDetections(TArray<FNeuralNetworkDetection>& OutDetections) const
+{
+    OutDetections.Reset(Tracks.Num());
+    for (const FTrack& Track : Tracks)
+    {
+        FNeuralNetworkDetection& Detection = OutDetections.Add_GetRef(Track.Box);
+        Detection.Score = Track.Confidence;
+        Detection.Min = FVector2D::Max(FVector2D::ZeroVector, Detection.Min);
+        Detection.Max = FVector2D::Min(FVector2D(FrameSize.X, FrameSize.Y), Detection.Max);
+    }
+
+    OutDetections.Sort([](const FNeuralNetworkDetection& A, const FNeuralNetworkDetection& B)
+    {
+        return A.Score > B.Score;
+    });
+}
+
+void FNeuralNetworkTracker::Reset()
+{
+    Tracks.Reset();
+    PreviousGrey.Reset();
+    CurrentGrey.Reset();
+    GreySize = FIntPoint::ZeroValue;
+    FrameSize = FIntPoint::ZeroValue;
+    FramesSinceDetection = 0;
+    bForceDetection = true;
+    Stats.ActiveTracks = 0;
+}
+
+FNeuralNetworkTrackerStats FNeuralNetworkTracker::GetStats() const
+{
+    return Stats;
+}
+
+/*
+- Parameters:
+ 1) Image: The frame to reduce.
+ 2) OutGrey: Receives GreySize.X x GreySize.Y bytes.
+- What it does: Box filters the green channel, which sits at the same byte in RGBA and BGRA, down by FlowDownsample.
+- Return Value: None.
+*/
+void FNeuralNetworkTracker::ComputeGrey(const FNeuralNetworkImageView& Image, TArray<uint8>& OutGrey) const
+{
+    OutGrey.SetNumUninitialized(GreySize.X * GreySize.Y, false);
+    if (!Image.Pixels || GreySize.X < 1 || GreySize.Y < 1)
+    {
+        OutGrey.Reset();
+        return;
+    }
+
+    const int32 Factor = Settings.FlowDownsample;
+    const int32 RowStride = Image.RowStride > 0 ? Image.RowStride : Image.Width * 4;
+    const uint32 Count = Factor * Factor;
+
+    ParallelFor(GreySize.Y, [&](int32 Y)
+    {
+        uint8* Out = OutGrey.GetData() + Y * GreySize.X;
+        for (int32 X = 0; X < GreySize.X; X++)
+        {
+            uint32 Sum = 0;
+            for (int32 sy = 0; sy < Factor; sy++)
+            {
+                const uint8* Pixel = Image.Pixels + static_cast<int64>(Y * Factor + sy) * RowStride + X * Factor * 4 + 1;
+                for (int32 sx = 0; sx < Factor; sx++)
+                {
+                    Sum += Pixel[sx * 4];
+                }
+            }
+            Out[X] = static_cast<uint8>(Sum / Count);
+        }
+    }, GreySize.Y < 32);
+}
+
+/*
+- Parameters:
+ 1) Track: The track, still at its position in the previous frame.
+ 2) OutMotion: Receives the motion of its center in source pixels.
+- What it does: Takes the PatchSize^2 grey patch around the track center in the previous frame and searches the
+  current frame for it within FlowSearchRadius of where the velocity says it went, by sum of absolute differences.
+- Return Value: bool, false when the patch is flat, too close to the border or the best match is worse than
+  FlowMaxError.
+*/
+bool FNeuralNetworkTracker::MatchFlow(const FTrack& Track, FVector2D& OutMotion) const
+{
+    using namespace NeuralNetworkTracker;
+
+    const int32 Factor = Settings.FlowDownsample;
+    const int32 Radius = Settings.FlowSearchRadius;
+    const int32 Stride = GreySize.X;
+    const FIntPoint MaxCorner(GreySize.X - PatchSize, GreySize.Y - PatchSize);
+
+    const FVector2D GreyCenter = Center(Track.Box) / Factor;
+    const FIntPoint Source(FMath::RoundToInt32(GreyCenter.X) - PatchSize / 2, FMath::RoundToInt32(GreyCenter.Y) - PatchSize / 2);
+    if (Source.X < 0 || Source.Y < 0 || Source.X > MaxCorner.X || Source.Y > MaxCorner.Y)
+    {
+        return false;
+    }
+
+    const uint8* Template = PreviousGrey.GetData() + Source.Y * Stride + Source.X;
+    uint8 Lowest = 255;
+    uint8 Highest = 0;
+    for (int32 y = 0; y < PatchSize; y++)
+    {
+        for (int32 x = 0; x < PatchSize; x++)
+        {
+            Lowest = FMath::Min(Lowest, Template[y * Stride + x]);
+            Highest = FMath::Max(Highest, Template[y * Stride + x]);
+        }
+    }
+    if (Highest - Lowest < MinPatchContrast)
+    {
+        return false;
+    }
+
+    const FIntPoint Guess = Source + FIntPoint(FMath::RoundToInt32(Track.Velocity.X / Factor), FMath::RoundToInt32(Track.Velocity.Y / Factor));
+    uint32 BestSad = MAX_uint32;
+    FIntPoint Best = Guess;
+    for (int32 Y = FMath::Max(0, Guess.Y - Radius); Y <= FMath::Min(MaxCorner.Y, Guess.Y + Radius); Y++)
+    {
+        for (int32 X = FMath::Max(0, Guess.X - Radius); X <= FMath::Min(MaxCorner.X, Guess.X + Radius); X++)
+        {
+            const uint32 Sad = PatchSad(Template, CurrentGrey.GetData() + Y * Stride + X, Stride);
+            if (Sad < BestSad)
+            {
+                BestSad = Sad;
+                Best = FIntPoint(X, Y);
+            }
+        }
+    }
+
+    if (BestSad == MAX_uint32 || static_cast<float>(BestSad) / (PatchSize * PatchSize) > Settings.FlowMaxError)
+    {
+        return false;
+    }
+
+    OutMotion = FVector2D(Best - Source) * Factor;
+    return true;
+}
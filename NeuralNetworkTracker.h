@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NeuralNetworkDetection.h"
+#include "NeuralNetworkPreprocess.h"
+
+#include "NeuralNetworkTracker.generated.h"
+
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkTrackerSettings
+{
+    GENERATED_BODY()
+
+public:
+
+    // The detector runs on every DetectInterval-th frame, the frames in between only move the existing tracks
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 DetectInterval = 6;
+
+    // The detector also runs as soon as any track's confidence falls below this
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float MinTrackConfidence = 0.2f;
+
+    // Confidence is multiplied by this on every predicted frame, and once more when the flow match failed
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float ConfidenceDecay = 0.92f;
+
+    // A detection only continues a track of the same class overlapping its predicted box by more than this
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float MatchIouThreshold = 0.3f;
+
+    // A track is dropped after this many detector runs in a row that did not match it
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 MaxMissedDetections = 2;
+
+    // Weight of a new motion measurement in the smoothed velocity, 1 trusts the last measurement only
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float VelocitySmoothing = 0.5f;
+
+    // Refine the predicted motion of each track by block matching a patch around its center between frames
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    bool bUseFlowRefinement = true;
+
+    // Block matching runs on a grey image downsampled by this factor
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 FlowDownsample = 4;
+
+    // Search radius around the velocity prediction, in downsampled pixels
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    int32 FlowSearchRadius = 4;
+
+    // Mean absolute grey difference (0-255) of the best match above which the match is ignored
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "NNE - Tutorial")
+    float FlowMaxError = 16.0f;
+};
+
+USTRUCT(BlueprintType, Category = "NNE - Tutorial")
+struct FNeuralNetworkTrackerStats
+{
+    GENERATED_BODY()
+
+public:
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 Frames = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 DetectorFrames = 0;
+
+    // Fraction of frames the detector ran on, 1 / DetectInterval when nothing forces extra runs
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    float DetectorRatio = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int32 ActiveTracks = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 TracksCreated = 0;
+
+    // Flow matches tried and rejected, the track fell back to its velocity
+    UPROPERTY(BlueprintReadOnly, Category = "NNE - Tutorial")
+    int64 FlowRejected = 0;
+};
+
+// Keeps detections alive between detector runs. Every frame the tracks are moved by their smoothed constant velocity,
+// optionally refined by SIMD block matching on a downsampled grey copy of the frame. On detector frames the
+// detections are associated with the predicted tracks by greedy IoU, which keeps TrackId stable per object.
+// Not thread safe.
+class TUTORIAL_API FNeuralNetworkTracker
+{
+public:
+
+    explicit FNeuralNetworkTracker(const FNeuralNetworkTrackerSettings& InSettings);
+
+    // Moves the tracks onto this frame. True when the detector has to run on it, Correct must then follow.
+    bool BeginFrame(const FNeuralNetworkImageView& Image);
+
+    // Associates the detector output of the current frame with the tracks
+    void Correct(const TArray<FNeuralNetworkDetection>& Detections);
+
+    // The tracks as detections with TrackId set, Score is the track confidence
+    void GetDetections(TArray<FNeuralNetworkDetection>& OutDetections) const;
+
+    // Drops all tracks, the next frame runs the detector
+    void Reset();
+
+    FNeuralNetworkTrackerStats GetStats() const;
+
+private:
+
+    struct FTrack
+    {
+        FNeuralNetworkDetection Box;
+        FVector2D Velocity = FVector2D::ZeroVector;
+
+        // Center at the last detector match, and frames since then
+        FVector2D MeasuredCenter = FVector2D::ZeroVector;
+        int32 FramesSinceMeasured = 0;
+
+        float Confidence = 0.0f;
+        int32 Hits = 0;
+        int32 Missed = 0;
+    };
+
+    void ComputeGrey(const FNeuralNetworkImageView& Image, TArray<uint8>& OutGrey) const;
+    bool MatchFlow(const FTrack& Track, FVector2D& OutMotion) const;
+
+    FNeuralNetworkTrackerSettings Settings;
+    TArray<FTrack> Tracks;
+
+    // Downsampled grey copies of the previous and current frame for block matching
+    TArray<uint8> PreviousGrey;
+    TArray<uint8> CurrentGrey;
+    FIntPoint GreySize = FIntPoint::ZeroValue;
+    FIntPoint FrameSize = FIntPoint::ZeroValue;
+
+    int32 FramesSinceDetection = 0;
+    bool bForceDetection = true;
+    int32 NextTrackId = 0;
+    FNeuralNetworkTrackerStats Stats;
+};